@@ -33,6 +33,27 @@ namespace rs
     namespace core
     {
 
+        /**
+        * @brief Parameters of the point cloud generation, see \c projection_interface::query_point_cloud.
+        */
+        struct point_cloud_params
+        {
+            int32_t decimation;     /**< Step between the depth pixels along both axes, 1 for every depth pixel */
+            float   min_depth;      /**< Minimal depth value of a valid point, in depth units */
+            float   max_depth;      /**< Maximal depth value of a valid point, in depth units, 0 for no limit */
+            bool    compact;        /**< True to write only the valid points, false to write a point per decimated depth pixel */
+        };
+
+        /**
+        * @brief Depth to color registration methods, see \c projection_interface::set_depth_to_color_registration.
+        */
+        enum class depth_to_color_registration : int32_t
+        {
+            inverse_uvmap = 0,  /**< Inverts the UV Map and remaps the depth image                                                  */
+            splat         = 1,  /**< Maps each depth pixel forward to a single color pixel, the nearest depth of a color pixel wins  */
+            splat_2x2     = 2   /**< Same as \c splat, each depth pixel covers 2x2 color pixels to reduce the holes                  */
+        };
+
         /**
 		* \brief
         * Defines mapping between cameras and projection to and unprojection from real world.
@@ -43,6 +64,9 @@ namespace rs
 		*
 		* Call the \c rs::core::projection::create_instance() method
         * to create an instance of this interface.
+        *
+        * An initialized instance is not modified by the mapping and query methods, so a single instance may be shared by many threads
+        * and called concurrently. \c reset must not be called while other threads use the instance.
         */
         class DLL_EXPORT projection_interface : public release_interface
         {
@@ -68,6 +92,10 @@ namespace rs
             * Retrieve depth coordinates based on provided color coordinates.
             * This method has optimized performance for a few pixels.
             * This method creates UV Map to perform the mapping.
+            * The UV Map is reused by the following calls with the same depth frame, identified by its frame number, time stamp and data.
+            * The UV Map of the last depth frame is kept, \c set_color_to_depth_cache_size keeps the UV Maps of a few frames.
+            * A depth image with frame number and time stamp both 0 is mapped without the reuse, so images which refill the same buffer
+            * with new frames should be given unique frame numbers to benefit from it.
             * @param[in]  depth           Depth map image
             * @param[in]  npoints         Number of pixels to be mapped
             * @param[in]  pos_ij          Array of color coordinates
@@ -205,6 +233,24 @@ namespace rs
             */
             virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color) = 0;
 
+            /**
+            * @brief Maps every color pixel for every depth pixel to a caller provided image buffer.
+            *
+            * Same as the image returning \c create_color_image_mapped_to_depth, without allocating the output image.
+            * The intermediate UV Map is kept by the instance and reused by following calls, so repeated calls
+            * of the same resolutions don't allocate memory. Concurrent calls use separate buffers, which are released with the instance.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  color                   Color image instance
+            * @param[in]  color2depth_info        Output image info, in the depth image resolution and the color image format
+            * @param[out] color2depth_data        Output image buffer, of \c color2depth_info.pitch * \c color2depth_info.height bytes
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image, color image or output buffer passed as parameter
+            * @return status_param_unsupported    The output image info doesn't match the depth and color images
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status create_color_image_mapped_to_depth(image_interface *depth, image_interface *color,
+                                                              const image_info &color2depth_info, uint8_t *color2depth_data) = 0;
+
             /**
             * @brief Maps every depth pixel to the color image resolution and outputs a depth image, aligned in space 
 			* and resolution to the color image.
@@ -221,10 +267,109 @@ namespace rs
             */
             virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color) = 0;
 
+            /**
+            * @brief Maps every depth pixel to the color image resolution in a caller provided image buffer.
+            *
+            * Same as the image returning \c create_depth_image_mapped_to_color, without allocating the output image.
+            * The intermediate UV Map and inverse UV Map are kept by the instance and reused by following calls, so repeated calls
+            * of the same resolutions don't allocate memory. Concurrent calls use separate buffers, which are released with the instance.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  color                   Color image instance
+            * @param[in]  depth2color_info        Output image info, in the color image resolution and the depth image format
+            * @param[out] depth2color_data        Output image buffer, of \c depth2color_info.pitch * \c depth2color_info.height bytes
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image, color image or output buffer passed as parameter
+            * @return status_param_unsupported    The output image info doesn't match the depth and color images
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status create_depth_image_mapped_to_color(image_interface *depth, image_interface *color,
+                                                              const image_info &depth2color_info, uint8_t *depth2color_data) = 0;
+
 
+            /**
+            * @brief Generates a point cloud with optional color in a single pass over the depth image.
+            *
+            * Every \c decimation depth pixel along both axes is deprojected to a vertex, like \c query_vertices, and if required, mapped to the color image
+            * like \c query_uvmap. Points with a zero depth or a depth out of the given range are invalid.
+            * If \c compact is set, only the valid points are written, otherwise a point is written per decimated depth pixel, in row order,
+            * with zero vertex, -1 uv coordinates and zero color for the invalid points.
+            * The output buffers are owned by the caller and are expected to hold
+            * <tt>((width + decimation - 1) / decimation) * ((height + decimation - 1) / decimation)</tt> points.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  color                   Color image instance, may be nullptr if \c colors is nullptr
+            * @param[in]  params                  Decimation, depth range and compaction of the point cloud
+            * @param[in]  max_points              Number of points the output buffers can hold
+            * @param[out] vertices                Vertices of the points, in real world coordinates
+            * @param[out] uvmap                   Normalized color image coordinates of the points, may be nullptr
+            * @param[out] colors                  Color pixel of the points, with the color image pixel size, may be nullptr
+            * @param[out] npoints                 Number of written points
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image, color image or output buffer passed as parameter
+            * @return status_param_unsupported    Invalid decimation or depth range, or the output buffers are too small
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_point_cloud(image_interface *depth, image_interface *color, const point_cloud_params &params, int32_t max_points,
+                                             point3dF32 *vertices, pointF32 *uvmap, uint8_t *colors, int32_t *npoints) = 0;
+            /**
+            * @brief Sets the number of threads which process the full image queries.
+            *
+            * The full image queries - \c query_uvmap, \c query_invuvmap, \c query_vertices, \c create_color_image_mapped_to_depth and
+            * \c create_depth_image_mapped_to_color, split the image rows between the calling thread and additional worker threads.
+            * The results are identical to the single threaded results.
+            * By default the queries run on the calling thread only.
+            * @param[in] threads_count            Number of threads, including the calling thread. 0 uses a thread per available core.
+            * @return status_no_error             Successful execution
+            */
+            virtual status set_threads_count(uint32_t threads_count) = 0;
+
+            /**
+            * @brief Sets the registration method of \c create_depth_image_mapped_to_color.
+            *
+            * The default method, \c depth_to_color_registration::inverse_uvmap, inverts the UV Map and samples the depth image,
+            * so where several depth pixels are mapped to the same color pixel, either of them may be selected.
+            * The splat methods write each depth pixel to the color pixels it is mapped to and keep the nearest depth,
+            * so foreground objects occlude the background at the objects edges.
+            * @param[in] registration             Registration method
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    Unknown registration method
+            */
+            virtual status set_depth_to_color_registration(depth_to_color_registration registration) = 0;
+
+            /**
+            * @brief Sets the number of depth frames which keep their \c map_color_to_depth mapping.
+            *
+            * Each kept frame holds a UV Map and an inverse UV Map, 8 bytes per depth pixel and 8 bytes per color pixel,
+            * which is about 19MB for a 640x480 depth image and a 1920x1080 color image. The mappings are kept until they are
+            * replaced by newer frames, the cache size is reduced or the instance is released.
+            * By default the mapping of the last frame is kept. Threads which map different depth frames at once replace each other's
+            * mapping, a cache of a frame per thread lets each of them reuse its own mapping. 0 disables the reuse.
+            * @param[in] frames_count             Number of kept frames, up to 4
+            * @return status_no_error             Successful execution
+            * @return status_param_unsupported    More than 4 frames requested
+            */
+            virtual status set_color_to_depth_cache_size(uint32_t frames_count) = 0;
+
+            /**
+            * @brief Removes the lens distortion of a color image, to an image of the same color camera without distortion.
+            *
+            * Used for the fisheye camera, which is mapped with the f-theta distortion model, and for other distorted color cameras.
+            * Every undistorted pixel is bilinearly interpolated from the color image, pixels out of the color image are set to 0.
+            * The undistortion map is built by the first call and reused by the following calls. A rectified color image is copied as is.
+            * @param[in]  color                   Color image instance, in an 8 bit per channel format
+            * @param[in]  undistorted_info        Output image info, in the color image resolution and format
+            * @param[out] undistorted_data        Output image buffer, of \c undistorted_info.pitch * \c undistorted_info.height bytes
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid color image or output buffer passed as parameter
+            * @return status_param_unsupported    The output image info doesn't match the color image
+            * @return status_feature_unsupported  The color image format or resolution is not supported
+            * @return status_data_unavailable     Incorrect color data passed in projection initialization
+            */
+            virtual status undistort_color_image(image_interface *color, const image_info &undistorted_info, uint8_t *undistorted_data) = 0;
              /**
              * @brief Creates an instance and initializes, based on intrinsic and extrinsic parameters.
              *
+             * Color intrinsics of the \c distortion_type::distortion_ftheta model, like the fisheye stream intrinsics, are mapped with the f-theta
+             * distortion model, with the extrinsics from the depth camera to the fisheye camera.
              * @param[in] colorIntrinsics         Camera color intrinsics
              * @param[in] depthIntrinsics         Camera depth intrinsics
              * @param[in] extrinsics              Camera depth to color extrinsics
@@ -0,0 +1,53 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file frame_reader_interface.h
+* @brief Describes the \c rs::playback::frame_reader_interface class.
+*/
+
+#pragma once
+#include <librealsense/rs.hpp>
+#include "rs/core/release_interface.h"
+#include "rs/core/image_interface.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+        * @brief Provides random access to the recorded frames, independently of the playback device streaming state.
+        *
+        * The frame reader reads the file data with its own file handles and decoders, and doesn't modify the playback device state.
+        * The reader is thread safe: multiple threads may read arbitrary frames from the same reader in parallel,
+        * each concurrent read is served by a separate file handle and decoder.
+        * The reader is created by \c rs::playback::context::create_frame_reader(), and must be released before the context is destroyed.
+        * Use \c rs::utils::get_unique_ptr_with_releaser from \c sdk/include/rs/utils/smart_ptr_helpers.h to release it automatically.
+        */
+        class frame_reader_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Reads and decodes the frame with the requested index from the file.
+            *
+            * The call blocks until the requested frame is indexed, in case the file indexing didn't reach it yet.
+            * The returned image owns the frame data, and should be released by the caller.
+            * @param[in] stream  Stream type of the requested frame
+            * @param[in] index   Zero-based frame index in the stream
+            * @return rs::core::image_interface*  Frame image, null if the stream wasn't recorded, or the index is out of the stream range
+            */
+            virtual rs::core::image_interface * read(rs::stream stream, uint32_t index) = 0;
+
+            /**
+            * @brief Gets the total frame count of the requested stream captured in the file.
+            *
+            * @param[in] stream  Stream type for which the frame count is queried
+            * @return int        Frame count
+            */
+            virtual int get_frame_count(rs::stream stream) = 0;
+        protected:
+            //force deletion using the release function
+            virtual ~frame_reader_interface() {}
+        };
+    }
+}
@@ -7,8 +7,11 @@
 */
 
 #pragma once
+#include <memory>
+#include <string>
 #include <librealsense/rs.hpp>
 #include "rs/core/context.h"
+#include "rs/playback/frame_reader_interface.h"
 
 #ifdef WIN32 
 #ifdef realsense_playback_EXPORTS
@@ -25,6 +28,40 @@ namespace rs
     namespace playback
     {
         class device;
+        class disk_read_interface;
+
+        /**
+        * @brief Recorded file which is played by several consumers.
+        *
+        * The shared recording indexes the file once. Playback contexts which are created from the shared recording
+        * share its samples index and decoded frames cache, instead of indexing the file again. Each context device
+        * has its own file read position, playback clock and streams selection, and is streamed independently of the other devices.
+        * The contexts keep the shared samples index alive, and may be destroyed after the shared recording.
+        */
+        class DLL_EXPORT shared_recording
+        {
+        public:
+            shared_recording(const char * file_path);
+            ~shared_recording();
+
+            /**
+            * @brief Indicates whether the recording file was opened.
+            *
+            * @return bool
+            * - true     The file was opened and is being indexed
+            * - false    The file failed to open
+            */
+            bool is_open() const;
+
+        private:
+            friend class context;
+            shared_recording(const shared_recording& recording) = delete;
+            shared_recording& operator=(const shared_recording& recording) = delete;
+
+            std::string                             m_file_path;
+            std::shared_ptr<disk_read_interface>    m_recording;
+        };
+
         /**
         * @brief Implements \c rs::core::context_interface for playback from recorded files. 
 		*
@@ -34,6 +71,14 @@ namespace rs
         {
         public:
             context(const char * file_path);
+
+            /**
+            * @brief Creates a playback context of a shared recording.
+            *
+            * The context device is a view of the shared recording, which uses the recording samples index instead of indexing the file.
+            * @param[in] recording  Shared recording to play
+            */
+            context(const shared_recording & recording);
             ~context();
 
             /**
@@ -61,6 +106,15 @@ namespace rs
              */
              device * get_playback_device();
 
+             /**
+             * @brief Creates a frame reader for random access to the recorded frames.
+             *
+             * The frame reader is independent of the playback device streaming state, and can be used concurrently to the streaming.
+             * Multiple readers may be created for the same context. The reader must be released before the context is destroyed.
+             * @return frame_reader_interface* Frame reader, null if the file failed to open
+             */
+             frame_reader_interface * create_frame_reader();
+
         private:
             context(const context& cxt) = delete;
             context& operator=(const context& cxt) = delete;
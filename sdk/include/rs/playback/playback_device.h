@@ -4,7 +4,7 @@
 /** 
 * \file playback_device.h
 * @brief Describes the \c rs::playback::device class, \c rs::playback::capture_mode 
-* and \c rs::playback::file_format enums, and \c rs::playback::file_info struct.
+* \c rs::playback::file_format and \c rs::playback::callback_queue_policy enums, and \c rs::playback::file_info and \c rs::playback::timing_stats structs.
 */
   
 #pragma once
@@ -42,6 +42,15 @@ namespace rs
             rs_linux_format = 1   /**<  Linux SDK format */
         };
 
+        /**
+        * @brief Frames which are dropped when the queue of a frame callback is full, in real time mode.
+        */
+        enum class callback_queue_policy
+        {
+            drop_oldest = 0,  /**<  The oldest queued frame is dropped, the callback receives the most recent frames */
+            drop_newest = 1   /**<  The new frame is dropped, the queued frames are all delivered */
+        };
+
         /**
         * @brief Describes the record software stack versions and file configuration.
         */
@@ -54,6 +63,23 @@ namespace rs
             playback::file_format           type;                        /**<  Indicates the file format, which is derived from the software stack that recorded it: Windows/Android RSSDK or Linux SDK */
         };
 
+        /**
+        * @brief Describes the real time playback timing accuracy.
+        *
+        * The delay of a sample is the difference between the time it was delivered and the time it was scheduled for,
+        * according to its capture time and the playback speed. The jitter is the change of the delay between consecutive samples,
+        * which is the error of the delivered inter-sample interval relative to the recorded one.
+        */
+        struct timing_stats
+        {
+            uint64_t                        samples_count;               /**<  Number of samples delivered in real time mode since the last streaming start or time base change */
+            double                          average_delay;               /**<  Average delivery delay, in microseconds */
+            double                          max_delay;                   /**<  Maximal delivery delay, in microseconds */
+            double                          delay_std_dev;               /**<  Standard deviation of the delivery delay, in microseconds */
+            double                          average_jitter;              /**<  Average absolute change of the delay between consecutive samples, in microseconds */
+            double                          max_jitter;                  /**<  Maximal absolute change of the delay between consecutive samples, in microseconds */
+        };
+
         /**
         * @brief Extends librealsense \c rs::device to provide playback capabilities. Commonly used for debug, testing and validation with known input.
         *
@@ -138,6 +164,190 @@ namespace rs
             */
             bool is_real_time();
 
+            /**
+            * @brief Sets the playback direction to reverse or forward.
+            *
+            * In reverse playback the samples are delivered in decreasing capture time order, starting from the frame preceding the last delivered frame.
+            * The streams stay time correlated, and the real time mode, the playback speed and the frame drops policy apply as in forward playback.
+            * The streaming ends when the first sample of the file is delivered.
+            * Combined with non real time mode, each \c wait_for_frames() call steps exactly one frame set backward.
+            * The direction can be changed while streaming, samples which were prefetched in the previous direction are discarded.
+            * The default direction is forward.
+            * @param[in] reverse  Requested direction, true for reverse playback
+            */
+            void set_reverse_playback(bool reverse);
+
+            /**
+            * @brief Indicates the playback direction.
+            *
+            * For more details, see the \c rs::playback::device::set_reverse_playback() method.
+            * @return bool Reverse playback state
+            */
+            bool is_reverse_playback();
+
+            /**
+            * @brief Limits the playback to a time range of the file.
+            *
+            * The range is given in the samples capture time, in microseconds since the start of the recording.
+            * Forward playback starts from the first sample captured at or after the range start, and the playback clock starts at this sample.
+            * The streaming ends, as in the end of the file, after the last sample captured up to the range end. Reverse playback starts from
+            * the range end and ends at the range start. The samples before the range start are skipped by their headers only,
+            * their data is not read or decoded. The range applies to the next streaming start, and to the following starts after stop,
+            * a range set while streaming takes effect immediately. To play the whole file, set the range to [0, max uint64_t].
+            * @param[in] start_time  Capture time of the range start, in microseconds
+            * @param[in] end_time    Capture time of the range end, in microseconds
+            * @return bool
+            * - true     The range was set
+            * - false    The range is invalid, or no sample was captured in the requested range
+            */
+            bool set_playback_range(uint64_t start_time, uint64_t end_time);
+
+            /**
+            * @brief Sets the forward playback to loop over the file, or over the playback range.
+            *
+            * In loop mode, once the last sample is delivered the playback continues from the first sample, without an end of file
+            * and without restarting the streaming. The file index is reused, and decoded frames which are still in the frame cache are not decoded again.
+            * The playback clock keeps running: the next loop starts a frame interval after the last sample, and the capture times, frame time stamps
+            * and motion time stamps of the samples keep increasing over the loops. Reverse playback is not looped.
+            * The mode can be changed while streaming. The default mode is no loop.
+            * @param[in] loop  Requested state, true to loop
+            */
+            void set_loop_playback(bool loop);
+
+            /**
+            * @brief Indicates the loop playback mode.
+            *
+            * For more details, see the \c rs::playback::device::set_loop_playback() method.
+            * @return bool Loop playback state
+            */
+            bool is_loop_playback();
+
+            /**
+            * @brief Gets the number of times the playback wrapped to the start since the streaming was started.
+            *
+            * @return uint32_t Number of completed loops
+            */
+            uint32_t get_loop_count();
+
+            /**
+            * @brief Sets the playback speed factor, relative to the recorded capture time.
+            *
+            * The speed factor scales the playback clock of the real time mode: 0.5 delivers the samples in slow motion at half the recorded rate,
+            * 2.0 delivers them twice as fast. The speed is applied on top of the real time mode and has no effect while real time mode is disabled.
+            * At high speeds, when decoding can't keep up with the requested rate, frames which are already late and are followed by another
+            * due frame of the same stream are skipped before decoding, and reported as frame drops.
+            * The speed can be changed while streaming, the playback clock is restarted from the current file read location.
+            * The default speed is 1.0.
+            * @param[in] speed  Requested speed factor, in the range [0.1, 32]
+            * @return bool
+            * - true     The speed was set
+            * - false    The requested speed is out of the supported range
+            */
+            bool set_playback_speed(double speed);
+
+            /**
+            * @brief Gets the playback speed factor.
+            *
+            * For more details, see the \c rs::playback::device::set_playback_speed() method.
+            * @return double Requested speed factor
+            */
+            double get_playback_speed();
+
+            /**
+            * @brief Gets the actual playback speed factor, as measured since the last streaming start or speed change.
+            *
+            * The achieved speed is the ratio between the elapsed capture time of the delivered samples and the elapsed playback time.
+            * It may be lower than the requested speed in case the system can't read and decode the samples fast enough.
+            * @return double Achieved speed factor, 0 if no sample was delivered yet
+            */
+            double get_achieved_playback_speed();
+
+            /**
+            * @brief Gets the real time playback timing statistics, since the last streaming start, speed change or direction change.
+            *
+            * In real time mode each sample is scheduled against an absolute deadline, derived from its capture time relative to the time base,
+            * so the delivery errors of previous samples don't accumulate over the file.
+            * The statistics are not updated while real time mode is disabled.
+            * @return timing_stats Delivery delay and jitter statistics
+            */
+            timing_stats get_timing_stats();
+
+            /**
+            * @brief Sets the size of the decoded frames cache.
+            *
+            * Decoded frames are kept in a least recently used cache, shared by the streaming, \c set_frame_by_index(), \c set_frame_by_timestamp()
+            * and the frame readers. Repeated access to recently read frames, such as stepping back and forth over the same frames, is served
+            * from the cache without reading and decoding the file data. Setting the size to 0 disables the cache.
+            * The cache is disabled by default, since the forward streaming reads each frame once and gains nothing from it.
+            * @param[in] size  Maximal total size of the cached images data, in bytes
+            */
+            void set_frame_cache_size(uint64_t size);
+
+            /**
+            * @brief Gets the size of the decoded frames cache.
+            *
+            * For more details, see the \c rs::playback::device::set_frame_cache_size() method.
+            * @return uint64_t Maximal total size of the cached images data, in bytes
+            */
+            uint64_t get_frame_cache_size();
+
+            /**
+            * @brief Sets the depth of the per stream frames queue, used to hand over frames to the frame callbacks in real time mode.
+            *
+            * Each stream with a frame callback has a queue of decoded frames, which are waiting for the callback thread.
+            * A frame is dropped only when the queue is full, according to the queue policy, so a deeper queue absorbs short delays of the callback,
+            * at the cost of delivering the queued frames later and keeping them in memory.
+            * The depth is applied on the next streaming start. The default depth is 4.
+            * @param[in] depth  Maximal number of frames waiting for the callback of each stream, in the range [1, 256]
+            * @return bool
+            * - true     The depth was set
+            * - false    The requested depth is out of the supported range
+            */
+            bool set_callback_queue_depth(uint32_t depth);
+
+            /**
+            * @brief Gets the depth of the per stream frames queue.
+            *
+            * For more details, see the \c rs::playback::device::set_callback_queue_depth() method.
+            * @return uint32_t Maximal number of frames waiting for the callback of each stream
+            */
+            uint32_t get_callback_queue_depth();
+
+            /**
+            * @brief Sets which frame is dropped when the frames queue of a stream is full, in real time mode.
+            *
+            * With the default policy, \c callback_queue_policy::drop_oldest, a callback which falls behind skips to the most recent frames,
+            * so the delivered frames keep up with the playback clock. With \c callback_queue_policy::drop_newest the queued frames
+            * are all delivered and the frames which arrive while the queue is full are dropped.
+            * The policy is applied on the next streaming start.
+            * @param[in] policy  Frames queue policy
+            */
+            void set_callback_queue_policy(callback_queue_policy policy);
+
+            /**
+            * @brief Gets which frame is dropped when the frames queue of a stream is full.
+            *
+            * For more details, see the \c rs::playback::device::set_callback_queue_policy() method.
+            * @return callback_queue_policy Frames queue policy
+            */
+            callback_queue_policy get_callback_queue_policy();
+
+            /**
+            * @brief Gets the highest number of frames which waited for the callback of the requested stream, since the last streaming start.
+            *
+            * A value which reaches the queue depth indicates that the callback didn't keep up with the stream, and frames may have been dropped.
+            * @param[in] stream  Stream type for which the high-water mark is queried
+            * @return uint32_t   Queue high-water mark, 0 if no frame callback is set for the stream
+            */
+            uint32_t get_callback_queue_high_water_mark(rs::stream stream);
+
+            /**
+            * @brief Gets the highest number of motion and timestamp samples which waited for the motion callbacks, since the last streaming start.
+            *
+            * @return uint32_t Queue high-water mark
+            */
+            uint32_t get_motion_callback_queue_high_water_mark();
+
             /**
             * @brief Gets the total frame count of the requested stream captured in the file.
             *
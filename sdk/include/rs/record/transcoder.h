@@ -0,0 +1,94 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file transcoder.h
+* @brief Describes the \c rs::record::transcoder class.
+*/
+
+#pragma once
+#include <map>
+#include <string>
+#include <librealsense/rs.hpp>
+#include "rs/core/status.h"
+#include "rs/record/record_device.h"
+
+#ifdef WIN32
+#ifdef realsense_transcoder_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_transcoder_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Re-compresses an existing recording to a new file.
+        *
+        * The transcoder reads the source file samples, decodes the frames and encodes them with the requested compression level,
+        * using a pool of worker threads. The target file contains the same device information, streams configuration and samples,
+        * in the same order and with the same capture times as the source file, only the frames compression differs.
+        * Recordings of previous file formats are converted to the current file format.
+        * The transcoder is built in its own library, realsense_transcoder, which depends on both the playback and the record libraries.
+        */
+        class DLL_EXPORT transcoder
+        {
+        public:
+            /**
+            * @brief Creates a transcoder of a single recording.
+            *
+            * @param[in] source_file_path  Path of the recording to transcode
+            * @param[in] target_file_path  Path of the created file, an existing file is overwritten
+            */
+            transcoder(const char * source_file_path, const char * target_file_path);
+
+            /**
+            * @brief Sets the target compression level of the selected stream.
+            *
+            * The default compression level is high, if no other level setting is made by the user.
+            * @param[in] stream             Stream type
+            * @param[in] compression_level  Requested compression level, \c compression_level::disabled writes uncompressed frames
+            */
+            void set_compression(rs::stream stream, compression_level compression_level);
+
+            /**
+            * @brief Sets the number of threads which decode and encode the frames.
+            *
+            * The default value, 0, uses a thread per available core.
+            * @param[in] threads_count  Number of worker threads
+            */
+            void set_threads_count(uint32_t threads_count);
+
+            /**
+            * @brief Transcodes the source file to the target file.
+            *
+            * The call blocks until all the samples are written to the target file.
+            * @return rs::core::status
+            * - status_no_error          The file was transcoded
+            * - status_file_open_failed  The source file failed to open
+            * - status_file_read_failed  A source frame failed to read or decode
+            * - status_file_write_failed The target file failed to be written
+            */
+            rs::core::status run();
+
+            /**
+            * @brief Gets the number of samples which were written to the target file by the last run.
+            *
+            * @return uint64_t Number of transcoded samples
+            */
+            uint64_t get_transcoded_samples_count() const { return m_transcoded_samples_count; }
+
+        private:
+            std::string                                 m_source_file_path;
+            std::string                                 m_target_file_path;
+            std::map<rs::stream, compression_level>     m_compression_config;
+            uint32_t                                    m_threads_count;
+            uint64_t                                    m_transcoded_samples_count;
+        };
+    }
+}
@@ -1,6 +1,7 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <cstring>
 #include "disk_read.h"
 #include "include/file.h"
 #include "rs/utils/log_utils.h"
@@ -16,6 +17,7 @@ namespace rs
         {
             LOG_FUNC_SCOPE();
             pause();
+            stop_indexing();
         }
 
        core::status disk_read::read_headers()
@@ -148,8 +150,6 @@ namespace rs
         {
             if (m_is_index_complete) return;
 
-            std::lock_guard<std::mutex> guard(m_mutex);
-
             for (uint32_t index = 0; index < number_of_samples;)
             {
                 chunk_info chunk = {};
@@ -186,8 +186,10 @@ namespace rs
                                     break;
                                 frame_info frame_info = fi.data;
                                 frame_info.index_in_stream = static_cast<uint32_t>(m_image_indices[frame_info.stream].size());
-                                m_image_indices[frame_info.stream].push_back(static_cast<uint32_t>(m_samples_desc.size()));
+                                //the descriptor is published before the stream index which points to it, the readers use the stream indices without locking
+                                auto sample_index = static_cast<uint32_t>(m_samples_desc.size());
                                 m_samples_desc.push_back(std::make_shared<frame_sample>(frame_info, sample_info));
+                                m_image_indices[frame_info.stream].push_back(sample_index);
                                 ++index;
                                 LOG_VERBOSE("frame sample indexed, sample time - " << sample_info.capture_time)
                                 break;
@@ -264,26 +266,24 @@ namespace rs
             return 0;
         }
 
-        uint32_t disk_read::read_frame_metadata(const std::shared_ptr<frame_sample>& frame, unsigned long num_bytes_to_read)
+        uint32_t disk_read::read_frame_metadata(const std::shared_ptr<frame_sample>& frame, const uint8_t * data, unsigned long num_bytes_to_read)
         {
             using metadata_pair_type = decltype(frame->metadata)::value_type; //gets the pair<K,V> of the map
             assert(num_bytes_to_read != 0); //if the chunk size is 0 there shouldn't be a chunk
             if(num_bytes_to_read % sizeof(metadata_pair_type) != 0) //num_bytes_to_read must be a multiplication of sizeof(metadata_pair_type)
             {
-                //in case data size is not valid move file pointer to the next chunk
+                //in case data size is not valid ignore the chunk
                 LOG_ERROR("failed to read frame metadata, metadata size is not valid");
-                m_file_data_read->set_position(num_bytes_to_read, rs::core::move_method::current);
-                return static_cast<uint32_t>(num_bytes_to_read);
+                return 0;
             }
             auto num_pairs = num_bytes_to_read / sizeof(metadata_pair_type);
             std::vector<metadata_pair_type> metadata_pairs(num_pairs);
-            uint32_t num_bytes_read = 0;
-            m_file_data_read->read_to_object_array(metadata_pairs);
+            memcpy(static_cast<void*>(metadata_pairs.data()), data, num_bytes_to_read);
             for(uint32_t i = 0; i < num_pairs; i++)
             {
                 frame->metadata.emplace(metadata_pairs[i].first, metadata_pairs[i].second);
             }
-            return num_bytes_read;
+            return static_cast<uint32_t>(num_bytes_to_read);
         }
     }
 }
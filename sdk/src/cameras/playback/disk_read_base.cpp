@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "disk_read_base.h"
+#include <algorithm>
+#include <cmath>
 #include <limits>
 #include <vector>
 #include "rs/core/metadata_interface.h"
@@ -9,12 +11,25 @@
 #include "rs/utils/log_utils.h"
 #include "rs_sdk_version.h"
 
+#ifndef WIN32
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
+
 using namespace rs::core;
 using namespace rs::playback;
 
-disk_read_base::disk_read_base(const char * file_path) : m_file_path(file_path), m_file_header(), m_pause(true),
-    m_realtime(true), m_streams_infos(), m_base_ts(0), m_is_index_complete(false),
-    m_samples_desc_index(0), m_is_motion_tracking_enabled(false)
+disk_read_base::disk_read_base(const char * file_path, std::shared_ptr<disk_read_interface> recording) : m_file_path(file_path), m_recording(recording),
+    m_index(recording ? std::static_pointer_cast<disk_read_base>(recording)->m_index : std::make_shared<samples_index>()), m_file_header(), m_pause(true),
+    m_realtime(true), m_reverse(false), m_streams_infos(), m_time_base{std::chrono::steady_clock::time_point(), 0, 1.0}, m_playback_speed(1.0), m_last_notified_ts(0), m_timing(),
+    m_wake_up_latency(MAX_DEADLINE_SPIN_TIME_US),
+    m_is_index_complete(m_index->is_complete), m_stop_indexing(false), m_index_mutex(m_index->mutex), m_index_cv(m_index->cv), m_frame_cache(m_index->frames),
+    m_image_indices(m_index->image_indices), m_samples_desc(m_index->samples_desc), m_samples_desc_index(0), m_last_notified_index(0),
+    m_range_end_time(std::numeric_limits<uint64_t>::max()), m_range_first_index(0), m_loop(false), m_loop_count(0), m_loop_time_offset(0),
+    m_is_motion_tracking_enabled(false)
 {
 
 }
@@ -22,6 +37,7 @@ disk_read_base::disk_read_base(const char * file_path) : m_file_path(file_path),
 disk_read_base::~disk_read_base(void)
 {
     LOG_FUNC_SCOPE();
+    stop_indexing();
 }
 
 rs::playback::file_info disk_read_base::query_file_info()
@@ -52,28 +68,15 @@ capture_mode disk_read_base::get_capture_mode()
         return capture_mode::synced;
     const uint32_t MIN_NUM_OF_FRAMES_TO_VALIDATE = 10;
     std::map<rs_stream,uint64_t> capture_times;
-    //index MIN_NUM_OF_FRAMES_TO_VALIDATE samples for each stream type
-    while(!m_is_index_complete)
-    {
-        index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-        if(m_image_indices.size() < m_streams_infos.size())
-            continue;
-
-        bool done = true;
-        for(auto indices : m_image_indices)
-        {
-            if(indices.second.size() < MIN_NUM_OF_FRAMES_TO_VALIDATE)
-            {
-                done = false;
-            }
-        }
-        if(done)
-            break;
-    }
+    //wait for MIN_NUM_OF_FRAMES_TO_VALIDATE samples of each stream type to be indexed
+    for(auto it = m_streams_infos.begin(); it != m_streams_infos.end(); ++it)
+        wait_for_frames(it->first, MIN_NUM_OF_FRAMES_TO_VALIDATE);
 
     //match capture times between the differnt streams
-    for(auto sample_desc : m_samples_desc)
+    auto number_of_samples = m_samples_desc.size();
+    for(uint32_t index = 0; index < number_of_samples; index++)
     {
+        auto sample_desc = m_samples_desc[index];
         if(sample_desc->info.type != file_types::sample_type::st_image)
             continue;
 
@@ -108,6 +111,14 @@ status disk_read_base::init()
 
     init_status = read_headers();
 
+    //a view uses the index of the recording, the file is indexed only once
+    if(m_recording)
+    {
+        m_file_header.capture_mode = m_recording->query_capture_mode();
+        LOG_INFO("init view " << (init_status == status_no_error ? "succeeded" : "failed") << "(status - " << init_status << ")");
+        return init_status;
+    }
+
     m_file_indexing = std::unique_ptr<file>(new file());
     init_status = m_file_indexing->open(m_file_path.c_str(), (open_file_option)(open_file_option::read));
     if (init_status < status_no_error) return init_status;
@@ -116,6 +127,8 @@ status disk_read_base::init()
     m_file_indexing->set_position(m_file_header.first_frame_offset, move_method::begin);
     LOG_INFO("init " << (init_status == status_no_error ? "succeeded" : "failed") << "(status - " << init_status << ")");
 
+    start_indexing();
+
     if(m_file_header.capture_mode == 0)
         m_file_header.capture_mode = get_capture_mode();
 
@@ -150,7 +163,10 @@ void disk_read_base::pause()
 void disk_read_base::read_thread()
 {
     LOG_FUNC_SCOPE();
-    m_base_sys_time = std::chrono::high_resolution_clock::now();
+    {
+        std::lock_guard<std::mutex> guard(m_time_base_mutex);
+        m_time_base.sys_time = std::chrono::steady_clock::now();
+    }
     auto eof = false;
     while (!m_pause && !eof)
     {
@@ -168,19 +184,146 @@ void disk_read_base::read_thread()
     LOG_INFO("Total number of dropped IMUs during playback - " << m_motion_drop_count);
 }
 
+std::shared_ptr<disk_read_interface> disk_read_base::query_recording()
+{
+    //views of a view share the index of the original recording
+    return m_recording ? m_recording : shared_from_this();
+}
+
+void disk_read_base::start_indexing()
+{
+    if(m_index_thread.joinable())
+        return;
+    m_stop_indexing = false;
+    m_index_thread = std::thread(&disk_read_base::index_thread, this);
+}
+
+void disk_read_base::stop_indexing()
+{
+    m_stop_indexing = true;
+    if(m_index_thread.joinable())
+        m_index_thread.join();
+}
+
+void disk_read_base::index_thread()
+{
+    LOG_FUNC_SCOPE();
+#ifndef WIN32
+    //indexing runs ahead of the playback, lower its priority so it won't compete with the samples reading thread
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), INDEXING_THREAD_NICE_VALUE);
+#endif
+    try
+    {
+        while(!m_stop_indexing && !m_is_index_complete)
+        {
+            index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+            std::lock_guard<std::mutex> guard(m_index_mutex);
+            m_index_cv.notify_all();
+        }
+        if(m_is_index_complete)
+            verify_number_of_frames();
+    }
+    catch(const std::exception & e)
+    {
+        LOG_ERROR("samples indexing failed - " << e.what());
+        m_is_index_complete = true;
+    }
+    //release all readers, no more samples will be indexed
+    std::lock_guard<std::mutex> guard(m_index_mutex);
+    m_index_cv.notify_all();
+}
+
+bool disk_read_base::wait_for_samples(uint32_t number_of_samples)
+{
+    if(m_samples_desc.size() >= number_of_samples)
+        return true;
+    std::unique_lock<std::mutex> guard(m_index_mutex);
+    m_index_cv.wait(guard, [this, number_of_samples]() -> bool
+    {
+        return m_samples_desc.size() >= number_of_samples || m_is_index_complete || m_stop_indexing;
+    });
+    return m_samples_desc.size() >= number_of_samples;
+}
+
+bool disk_read_base::wait_for_frames(rs_stream stream, uint32_t number_of_frames)
+{
+    auto it = m_image_indices.find(stream);
+    if(it == m_image_indices.end())
+        return false;
+    auto & indices = it->second;
+    if(indices.size() >= number_of_frames)
+        return true;
+    std::unique_lock<std::mutex> guard(m_index_mutex);
+    m_index_cv.wait(guard, [this, &indices, number_of_frames]() -> bool
+    {
+        return indices.size() >= number_of_frames || m_is_index_complete || m_stop_indexing;
+    });
+    return indices.size() >= number_of_frames;
+}
+
 void disk_read_base::init_decoder()
+{
+    std::map<rs_stream, file_types::stream_info> active_streams;
+    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+        active_streams[it->first] = it->second.m_stream_info;
+    create_decoder(active_streams, m_decoder, m_encoded_data);
+}
+
+void disk_read_base::create_decoder(const std::map<rs_stream, file_types::stream_info> & streams_infos,
+                                    std::shared_ptr<compression::decoder> & decoder, std::vector<uint8_t> & encoded_data)
 {
     std::map<rs_stream,file_types::compression_type> compression_config;
     uint32_t buffer_size = 0;
-    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+    for(auto it = streams_infos.begin(); it != streams_infos.end(); ++it)
     {
-        uint32_t size = it->second.m_stream_info.profile.info.width * it->second.m_stream_info.profile.info.height;
+        uint32_t size = it->second.profile.info.width * it->second.profile.info.height;
         buffer_size = size > buffer_size ? size : buffer_size;
-        compression_config.emplace(it->first, it->second.m_stream_info.ctype);
+        compression_config.emplace(it->first, it->second.ctype);
     }
 
-    m_decoder.reset(new compression::decoder(compression_config));
-    m_encoded_data = std::vector<uint8_t>(buffer_size * 4);//stride is not availabe, taking worst case.
+    decoder.reset(new compression::decoder(compression_config));
+    encoded_data = std::vector<uint8_t>(buffer_size * 4);//stride is not availabe, taking worst case.
+}
+
+std::unique_ptr<image_read_context> disk_read_base::create_image_read_context()
+{
+    std::unique_ptr<image_read_context> context(new image_read_context());
+    context->file = std::unique_ptr<file>(new file());
+    if(context->file->open(m_file_path.c_str(), (open_file_option)(open_file_option::read)) < status_no_error)
+        return nullptr;
+    //the context may read any of the recorded streams, regardless of the streams enabled for streaming
+    create_decoder(m_streams_infos, context->decoder, context->encoded_data);
+    return context;
+}
+
+std::shared_ptr<file_types::frame_sample> disk_read_base::read_frame(rs_stream stream, uint32_t index, image_read_context & context)
+{
+    //the samples index is lock free for readers, the streaming state is not accessed.
+    if(!wait_for_frames(stream, index + 1)) return nullptr;
+    auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[m_image_indices.at(stream)[index]]);
+    if(!frame) return nullptr;
+    auto rv = m_frame_cache.get(stream, index);
+    if(rv) return rv;
+    rv = read_image_buffer(frame, *context.file, *context.decoder, context.encoded_data);
+    m_frame_cache.put(stream, index, rv);
+    return rv;
+}
+
+std::shared_ptr<file_types::sample> disk_read_base::read_sample(uint32_t index, image_read_context & context)
+{
+    //samples are read in file order, frames are decoded without going through the frames cache
+    if(!wait_for_samples(index + 1)) return nullptr;
+    auto sample = m_samples_desc[index];
+    if(sample->info.type != file_types::sample_type::st_image)
+        return sample;
+    auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+    return read_image_buffer(frame, *context.file, *context.decoder, context.encoded_data);
+}
+
+uint32_t disk_read_base::query_number_of_samples()
+{
+    wait_for_samples(std::numeric_limits<uint32_t>::max());
+    return static_cast<uint32_t>(m_samples_desc.size());
 }
 
 void disk_read_base::set_total_frame_drop_count(double value)
@@ -205,13 +348,16 @@ void disk_read_base::reset()
     pause();
     std::lock_guard<std::mutex> guard(m_mutex);
     m_file_data_read->reset();
-    m_samples_desc_index = 0;
+    m_samples_desc_index = m_range_first_index;
+    m_last_notified_index = m_range_first_index;
+    m_loop_count = 0;
+    m_loop_time_offset = 0;
+    m_reverse = false;
     std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
     std::swap(m_prefetched_samples, empty_queue);
     for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
     {
         active_stream_info & asi = it->second;
-        asi.m_image_indices = m_image_indices[it->first];
         asi.m_prefetched_samples_count = 0;
         asi.m_stream_info = m_streams_infos[it->first];
     }
@@ -225,7 +371,6 @@ void disk_read_base::enable_stream(rs_stream stream, bool state)
     if(state)
     {
         active_stream_info asi;
-        asi.m_image_indices = m_image_indices[stream];
         asi.m_prefetched_samples_count = 0;
         asi.m_stream_info = m_streams_infos[stream];
         m_active_streams_info[stream] = asi;
@@ -251,6 +396,8 @@ void disk_read_base::notify_available_samples()
         if(m_prefetched_samples.empty())break;
         time_to_next_sample = calc_sleep_time(m_prefetched_samples.front());
         if(time_to_next_sample > 0 && m_realtime)break;
+        if(m_realtime)
+            update_timing_stats(-time_to_next_sample);
 
         //handle next sample if its time has come
         if(m_prefetched_samples.front()->info.type == file_types::sample_type::st_image)
@@ -259,23 +406,26 @@ void disk_read_base::notify_available_samples()
             if (frame)
             {
                 m_active_streams_info[frame->finfo.stream].m_prefetched_samples_count--;
+                m_last_notified_index = m_image_indices.at(frame->finfo.stream)[frame->finfo.index_in_stream] + 1;
                 LOG_VERBOSE("calling callback, frame stream type - " << frame->finfo.stream);
             }
         }
         LOG_VERBOSE("calling callback, sample type - " << m_prefetched_samples.front()->info.type);
         LOG_VERBOSE("calling callback, sample capture time - " << m_prefetched_samples.front()->info.capture_time);
-        m_sample_callback(m_prefetched_samples.front());
+        m_last_notified_ts = m_prefetched_samples.front()->info.capture_time + m_loop_time_offset;
+        m_sample_callback(m_loop_time_offset > 0 ? shift_sample_time(m_prefetched_samples.front()) : m_prefetched_samples.front());
         m_prefetched_samples.pop();
     }
 }
 
 void disk_read_base::prefetch_sample()
 {
-    if(m_samples_desc_index >= m_samples_desc.size() || all_samples_bufferd())
+    if(!has_samples_to_prefetch() || all_samples_bufferd())
         return;
-    LOG_VERBOSE("process sample - " << m_samples_desc_index);
-    auto sample = m_samples_desc[m_samples_desc_index];
-    m_samples_desc_index++;
+    //in reverse playback the samples are read behind the current position
+    auto sample_index = m_reverse ? --m_samples_desc_index : m_samples_desc_index++;
+    LOG_VERBOSE("process sample - " << sample_index);
+    auto sample = m_samples_desc[sample_index];
     std::lock_guard<std::mutex> guard(m_mutex);
     switch(sample->info.type)
     {
@@ -286,6 +436,13 @@ void disk_read_base::prefetch_sample()
             {
                 //don't prefatch frame if stream is disabled.
                 if(m_active_streams_info.find(frame->finfo.stream) == m_active_streams_info.end()) return;
+                //skip decoding of frames that can't be delivered on time
+                if(is_frame_late(frame))
+                {
+                    LOG_VERBOSE("frame skipped, stream - " << frame->finfo.stream << " ,capture time - " << frame->info.capture_time);
+                    update_frame_drop_count(frame->finfo.stream, 1);
+                    return;
+                }
                 auto curr = read_image_buffer(frame);
                 if(curr)
                 {
@@ -317,9 +474,13 @@ bool disk_read_base::read_next_sample()
 {
     //indicate to device all samples which time elapsed (timestamp is in the past of the playback clock)
     notify_available_samples();
-    while(m_samples_desc_index >= m_samples_desc.size() && !m_is_index_complete)
-        index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-    if(m_samples_desc_index >= m_samples_desc.size() && m_prefetched_samples.size() == 0)
+    if(!m_reverse)
+        wait_for_samples(m_samples_desc_index + 1);
+    //in loop mode the forward playback wraps to the range start once the last sample of the range was delivered
+    if(m_loop && !m_reverse && m_prefetched_samples.size() == 0 && !has_samples_to_prefetch() &&
+       (m_is_index_complete || m_samples_desc_index < m_samples_desc.size()))
+        loop_to_range_start();
+    if(!has_samples_to_prefetch() && m_prefetched_samples.size() == 0)
         return false;
     //optimize next reads - prefetch a single sample.
     //This sample will be indicated to the device on the next iteration of the calling function if its time arrived.
@@ -328,13 +489,10 @@ bool disk_read_base::read_next_sample()
     //goto sleep in case we have at least one frame ready for each stream, and playing in realtime
     if(all_samples_bufferd() && m_realtime)
     {
-        int64_t time_to_next_sample;
-        while((time_to_next_sample  = calc_sleep_time(m_prefetched_samples.front())) > 1e3)
+        //the deadline is recalculated after waking up, in case the time base was updated while sleeping
+        while(!m_pause && calc_sleep_time(m_prefetched_samples.front()) > 0)
         {
-            if(m_is_index_complete)
-                std::this_thread::sleep_for(std::chrono::microseconds(time_to_next_sample));
-            else
-               index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+            sleep_until(calc_deadline(m_prefetched_samples.front()));
         }
     }
     return true;
@@ -343,7 +501,9 @@ bool disk_read_base::read_next_sample()
 bool disk_read_base::all_samples_bufferd()
 {
     //no more samples to prefetch - all available samples are buffered
-    if(m_is_index_complete && m_samples_desc_index >= m_samples_desc.size() && m_prefetched_samples.size() > 0) return true;
+    //in forward playback, a sample which wasn't indexed yet may still be in the playback range
+    auto all_samples_prefetched = !has_samples_to_prefetch() && (m_reverse || m_is_index_complete || m_samples_desc_index < m_samples_desc.size());
+    if(all_samples_prefetched && m_prefetched_samples.size() > 0) return true;
 
     for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
     {
@@ -376,9 +536,7 @@ std::map<rs_stream, std::shared_ptr<rs::core::file_types::frame_sample>> disk_re
 
     pause();
 
-    while(index >= m_image_indices[stream_type].size() && !m_is_index_complete) index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-
-    if (index >= m_image_indices[stream_type].size()) return rv;
+    if (!wait_for_frames(stream_type, index + 1)) return rv;
 
 
     //return current frames for all streams.
@@ -403,21 +561,13 @@ std::map<rs_stream, std::shared_ptr<rs::core::file_types::frame_sample>> disk_re
     // Index the streams until we have at least a stream whose time stamp is bigger than ts.
     do
     {
-        if(index >= m_samples_desc.size())
-        {
-            if(m_is_index_complete)return rv;
-            index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-        }
+        if(!wait_for_samples(index + 1))return rv;
+        if(m_samples_desc[index]->info.type != file_types::sample_type::st_image)continue;
+        auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[index]);
+        if(frame->finfo.time_stamp >= ts)
         {
-            if(index >= m_samples_desc.size())continue;
-            std::lock_guard<std::mutex> guard(m_mutex);
-            if(m_samples_desc[index]->info.type != file_types::sample_type::st_image)continue;
-            auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[index]);
-            if(frame->finfo.time_stamp >= ts)
-            {
-                stream = frame->finfo.stream;
-                break;
-            }
+            stream = frame->finfo.stream;
+            break;
         }
     }
     while(++index);
@@ -440,8 +590,8 @@ std::map<rs_stream, std::shared_ptr<file_types::frame_sample> > disk_read_base::
 {
     std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> rv;
 
-    std::map<rs_stream, uint64_t> prev_index;
-    std::map<rs_stream, uint64_t> next_index;
+    std::map<rs_stream, uint32_t> prev_index;
+    std::map<rs_stream, uint32_t> next_index;
     auto index = sample_index;
     while(index > 0 && prev_index.size() < m_active_streams_info.size())
     {
@@ -454,12 +604,7 @@ std::map<rs_stream, std::shared_ptr<file_types::frame_sample> > disk_read_base::
     index = sample_index;
     while(next_index.size() < m_active_streams_info.size())
     {
-        if(index + 1 >= m_samples_desc.size())
-        {
-            if(m_is_index_complete)break;
-            index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
-        }
-        if(index + 1 >= m_samples_desc.size())continue;
+        if(!wait_for_samples(index + 2))break;
         index++;
         if(m_samples_desc[index]->info.type != file_types::sample_type::st_image)continue;
         auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_samples_desc[index]);
@@ -495,6 +640,8 @@ std::map<rs_stream, std::shared_ptr<file_types::frame_sample> > disk_read_base::
     {
         std::lock_guard<std::mutex> guard(m_mutex);
         m_samples_desc_index = sample_index;
+        m_last_notified_index = sample_index + 1;
+        m_loop_time_offset = 0;
     }
     std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
     std::swap(m_prefetched_samples, empty_queue);
@@ -512,53 +659,341 @@ void disk_read_base::set_realtime(bool realtime)
     LOG_INFO((realtime ? "enable" : "disable") << " realtime");
 }
 
+void disk_read_base::set_reverse(bool reverse)
+{
+    auto previous_state = m_pause;
+    pause();
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_reverse = reverse;
+        m_loop_time_offset = 0;
+        //continue from the last indicated frame in the requested direction, samples prefetched in the previous direction are dropped
+        m_samples_desc_index = reverse ? (m_last_notified_index > 0 ? m_last_notified_index - 1 : 0) : m_last_notified_index;
+        std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
+        std::swap(m_prefetched_samples, empty_queue);
+        for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+            it->second.m_prefetched_samples_count = 0;
+    }
+    //set time base to currnt sample time
+    update_time_base();
+    LOG_INFO((reverse ? "enable" : "disable") << " reverse playback");
+
+    if(!previous_state)
+        resume();
+}
+
+bool disk_read_base::set_playback_range(uint64_t start_time, uint64_t end_time)
+{
+    if(start_time > end_time)
+    {
+        LOG_ERROR("invalid playback range, start time - " << start_time << " ,end time - " << end_time);
+        return false;
+    }
+    auto previous_state = m_pause;
+    pause();
+
+    //the indexing thread reads only the samples headers, so skipping to the range start doesn't read or decode the skipped samples data
+    uint32_t first_index = 0;
+    while(wait_for_samples(first_index + 1) && m_samples_desc[first_index]->info.capture_time < start_time)
+        first_index++;
+    if(first_index >= m_samples_desc.size() || m_samples_desc[first_index]->info.capture_time > end_time)
+    {
+        LOG_ERROR("no samples in playback range, start time - " << start_time << " ,end time - " << end_time);
+        if(!previous_state)
+            resume();
+        return false;
+    }
+    //reverse playback starts from the range end, which must be indexed first
+    auto end_index = first_index + 1;
+    if(m_reverse)
+    {
+        while(wait_for_samples(end_index + 1) && m_samples_desc[end_index]->info.capture_time <= end_time)
+            end_index++;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_range_end_time = end_time;
+        m_range_first_index = first_index;
+        m_samples_desc_index = m_reverse ? end_index : first_index;
+        m_last_notified_index = m_samples_desc_index;
+        m_loop_time_offset = 0;
+        std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
+        std::swap(m_prefetched_samples, empty_queue);
+        for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+            it->second.m_prefetched_samples_count = 0;
+    }
+    //the playback clock starts at the first sample of the range
+    update_time_base();
+    LOG_INFO("playback range set to - " << start_time << " - " << end_time << " ,first sample index - " << first_index);
+
+    if(!previous_state)
+        resume();
+    return true;
+}
+
+void disk_read_base::loop_to_range_start()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if(m_samples_desc_index <= m_range_first_index)
+        return;
+    //the next loop starts a frame interval after the last sample of the range, so the playback clock keeps running without a gap
+    //and the capture times keep increasing. the index and the cached frames are reused as is.
+    int32_t max_frame_rate = 0;
+    for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
+        max_frame_rate = std::max(max_frame_rate, it->second.m_stream_info.profile.frame_rate);
+    uint64_t frame_interval = max_frame_rate > 0 ? 1000000 / static_cast<uint64_t>(max_frame_rate) : 1;
+    auto loop_duration = m_samples_desc[m_samples_desc_index - 1]->info.capture_time - m_samples_desc[m_range_first_index]->info.capture_time;
+    m_loop_time_offset += loop_duration + frame_interval;
+    m_samples_desc_index = m_range_first_index;
+    m_loop_count++;
+    LOG_INFO("loop playback, loop - " << m_loop_count << " ,time offset - " << m_loop_time_offset);
+}
+
+std::shared_ptr<file_types::sample> disk_read_base::shift_sample_time(const std::shared_ptr<file_types::sample> & sample)
+{
+    //the samples of a loop are delivered as shifted copies, the descriptors and the cached frames are shared and are not modified
+    auto time_stamp_offset = static_cast<double>(m_loop_time_offset) / 1000.0;
+    switch(sample->info.type)
+    {
+        case file_types::sample_type::st_image:
+        {
+            auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+            //the copy refers to the original image data, which is kept alive by the copy
+            auto shifted = std::shared_ptr<file_types::frame_sample>(new file_types::frame_sample(frame.get()), [frame](file_types::frame_sample * f) { delete f; });
+            shifted->data = frame->data;
+            shifted->info.capture_time += m_loop_time_offset;
+            shifted->finfo.time_stamp += time_stamp_offset;
+            return shifted;
+        }
+        case file_types::sample_type::st_motion:
+        {
+            auto motion = std::static_pointer_cast<file_types::motion_sample>(sample);
+            auto shifted = std::make_shared<file_types::motion_sample>(motion->data, motion->info);
+            shifted->info.capture_time += m_loop_time_offset;
+            shifted->data.timestamp_data.timestamp += time_stamp_offset;
+            return shifted;
+        }
+        case file_types::sample_type::st_time:
+        {
+            auto time_stamp = std::static_pointer_cast<file_types::time_stamp_sample>(sample);
+            auto shifted = std::make_shared<file_types::time_stamp_sample>(time_stamp->data, time_stamp->info);
+            shifted->info.capture_time += m_loop_time_offset;
+            shifted->data.timestamp += time_stamp_offset;
+            return shifted;
+        }
+        default: return sample;
+    }
+}
+
+bool disk_read_base::has_samples_to_prefetch()
+{
+    if(m_reverse)
+        return m_samples_desc_index > m_range_first_index;
+    return m_samples_desc_index < m_samples_desc.size() && m_samples_desc[m_samples_desc_index]->info.capture_time <= m_range_end_time;
+}
+
+bool disk_read_base::set_playback_speed(double speed)
+{
+    if(speed < MIN_PLAYBACK_SPEED || speed > MAX_PLAYBACK_SPEED)
+    {
+        LOG_ERROR("playback speed is out of range, requested speed - " << speed);
+        return false;
+    }
+    m_playback_speed = speed;
+
+    //set time base to currnt sample time
+    update_time_base();
+    LOG_INFO("playback speed set to " << speed);
+    return true;
+}
+
+double disk_read_base::query_achieved_playback_speed()
+{
+    auto base = query_time_base();
+    auto time_span = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - base.sys_time).count();
+    uint64_t base_ts = base.ts;
+    uint64_t last_notified_ts = m_last_notified_ts;
+    //the time base may be updated between the reads, a sample which precedes the time base is ignored
+    auto played_time_span = static_cast<int64_t>(m_reverse ? base_ts - last_notified_ts : last_notified_ts - base_ts);
+    if(time_span == 0 || played_time_span <= 0)
+        return 0;
+    return static_cast<double>(played_time_span) / static_cast<double>(time_span);
+}
+
+void disk_read_base::verify_number_of_frames()
+{
+    //the header frames count is trusted on startup, once the whole file is indexed it is verified against the indexed frames
+    for(auto & stream_info : m_streams_infos)
+    {
+        auto nframes = static_cast<uint32_t>(stream_info.second.nframes);
+        auto it = m_image_indices.find(stream_info.first);
+        auto indexed_frames = it != m_image_indices.end() ? static_cast<uint32_t>(it->second.size()) : 0;
+        if(nframes > 0 && nframes != indexed_frames)
+            LOG_WARN("stream - " << stream_info.first << ", header number of frames - " << nframes << " doesn't match the indexed number of frames - " << indexed_frames);
+    }
+}
+
 uint32_t disk_read_base::query_number_of_frames(rs_stream stream_type)
 {
+    //the indexed frames count is exact once the whole file is indexed
+    if(m_is_index_complete)
+    {
+        auto it = m_image_indices.find(stream_type);
+        return it != m_image_indices.end() ? static_cast<uint32_t>(it->second.size()) : 0;
+    }
+
     uint32_t nframes = m_streams_infos[stream_type].nframes;
 
     if (nframes > 0) return nframes;
 
     /* If not able to get from the header, let's count */
-    while (!m_is_index_complete) index_next_samples(std::numeric_limits<uint32_t>::max());
+    wait_for_samples(std::numeric_limits<uint32_t>::max());
 
     return (int32_t)m_image_indices[stream_type].size();
 }
 
 uint64_t disk_read_base::query_run_time()
 {
-    auto now = std::chrono::high_resolution_clock::now();
-    return std::chrono::duration_cast<std::chrono::microseconds>(now - m_base_sys_time).count();
+    auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now - query_time_base().sys_time).count();
+}
+
+disk_read_base::time_base disk_read_base::query_time_base()
+{
+    std::lock_guard<std::mutex> guard(m_time_base_mutex);
+    return m_time_base;
+}
+
+std::chrono::steady_clock::time_point disk_read_base::calc_deadline(std::shared_ptr<file_types::sample> sample)
+{
+    auto time_stamp = sample->info.capture_time + m_loop_time_offset;
+    auto base = query_time_base();
+    //the recorded time since the time base, scaled by the playback speed.
+    //in reverse playback the recorded time runs backwards from the time base
+    auto recorded_time_span = static_cast<double>(static_cast<int64_t>(m_reverse ? base.ts - time_stamp : time_stamp - base.ts)) / base.speed;
+    return base.sys_time + std::chrono::microseconds(static_cast<int64_t>(recorded_time_span));
 }
 
 int64_t disk_read_base::calc_sleep_time(std::shared_ptr<file_types::sample> sample)
 {
-    auto time_span = query_run_time();
-    auto time_stamp = sample->info.capture_time;
-    //number of miliseconds to wait - the diff in milisecond between the last call for streaming resume
-    //and the recorded time.
-    int wait_for = static_cast<int>(time_stamp - m_base_ts - time_span);
-    LOG_VERBOSE("sleep length " << wait_for << " miliseconds");
-    LOG_VERBOSE("total run time - " << time_span);
+    //number of microseconds to wait until the sample deadline, negative if the deadline passed
+    auto wait_for = static_cast<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(calc_deadline(sample) - std::chrono::steady_clock::now()).count());
+    LOG_VERBOSE("sleep length " << wait_for << " microseconds");
     return wait_for;
 }
 
-void disk_read_base::update_time_base()
+void disk_read_base::sleep_until(std::chrono::steady_clock::time_point deadline)
+{
+    auto wake_up_time = deadline - std::chrono::microseconds(m_wake_up_latency);
+    if(std::chrono::steady_clock::now() < wake_up_time)
+    {
+#ifndef WIN32
+        //sleep against the absolute deadline, so the sleep length doesn't depend on the time it took to calculate it.
+        //steady_clock is based on CLOCK_MONOTONIC
+        auto wake_up_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wake_up_time.time_since_epoch()).count();
+        timespec wake_up_spec = {};
+        wake_up_spec.tv_sec = static_cast<time_t>(wake_up_ns / 1000000000);
+        wake_up_spec.tv_nsec = static_cast<long>(wake_up_ns % 1000000000);
+        while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake_up_spec, nullptr) == EINTR);
+#else
+        std::this_thread::sleep_until(wake_up_time);
+#endif
+        //the spin covers the scheduler wake up latency, it follows a rise at once and decays slowly,
+        //so a system which wakes up on time hardly spins
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - wake_up_time).count();
+        if(latency >= m_wake_up_latency)
+            m_wake_up_latency = std::min<int64_t>(latency, MAX_DEADLINE_SPIN_TIME_US);
+        else
+            m_wake_up_latency -= (m_wake_up_latency - latency + 7) / 8;
+    }
+    while(std::chrono::steady_clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void disk_read_base::update_timing_stats(int64_t delay)
+{
+    auto delay_us = static_cast<double>(delay);
+    std::lock_guard<std::mutex> guard(m_timing_mutex);
+    if(m_timing.count > 0)
+    {
+        auto jitter = std::abs(delay_us - m_timing.last_delay);
+        m_timing.jitter_sum += jitter;
+        m_timing.max_jitter = std::max(m_timing.max_jitter, jitter);
+    }
+    m_timing.count++;
+    m_timing.delay_sum += delay_us;
+    m_timing.delay_square_sum += delay_us * delay_us;
+    m_timing.max_delay = std::max(m_timing.max_delay, delay_us);
+    m_timing.last_delay = delay_us;
+}
+
+rs::playback::timing_stats disk_read_base::query_timing_stats()
 {
-    m_base_sys_time = std::chrono::high_resolution_clock::now();
+    std::lock_guard<std::mutex> guard(m_timing_mutex);
+    rs::playback::timing_stats stats = {};
+    stats.samples_count = m_timing.count;
+    if(m_timing.count == 0)
+        return stats;
+    auto count = static_cast<double>(m_timing.count);
+    stats.average_delay = m_timing.delay_sum / count;
+    stats.max_delay = m_timing.max_delay;
+    stats.delay_std_dev = std::sqrt(std::max(0.0, m_timing.delay_square_sum / count - stats.average_delay * stats.average_delay));
+    if(m_timing.count > 1)
+        stats.average_jitter = m_timing.jitter_sum / (count - 1);
+    stats.max_jitter = m_timing.max_jitter;
+    return stats;
+}
 
+bool disk_read_base::is_frame_late(std::shared_ptr<file_types::frame_sample> frame)
+{
+    if(!m_realtime || calc_sleep_time(frame) >= 0)
+        return false;
+    //a late frame is skipped only if the next frame of the same stream is already due,
+    //otherwise it is still the most recent frame available for that stream
+    auto & indices = m_image_indices[frame->finfo.stream];
+    if(m_reverse && frame->finfo.index_in_stream == 0)
+        return false;
+    auto next_index = m_reverse ? frame->finfo.index_in_stream - 1 : frame->finfo.index_in_stream + 1;
+    if(next_index >= indices.size())
+        return false;
+    return calc_sleep_time(m_samples_desc[indices[next_index]]) <= 0;
+}
+
+void disk_read_base::update_time_base()
+{
+    {
+        std::lock_guard<std::mutex> timing_guard(m_timing_mutex);
+        m_timing = timing_accumulator();
+    }
     std::lock_guard<std::mutex> guard(m_mutex);
-    if(m_samples_desc_index > 0)
+    uint64_t base_ts = 0;
+    if(m_reverse)
+    {
+        if(m_prefetched_samples.size() > 0)
+            base_ts = m_prefetched_samples.front()->info.capture_time;
+        else
+            base_ts = m_samples_desc_index > 0 ? m_samples_desc[m_samples_desc_index - 1]->info.capture_time : 0;
+    }
+    else if(m_samples_desc_index > 0)
     {
         if(m_prefetched_samples.size() > 0)
-            m_base_ts = m_prefetched_samples.front()->info.capture_time;
+            base_ts = m_prefetched_samples.front()->info.capture_time;
         else
-            m_base_ts = m_samples_desc_index < m_samples_desc.size() ?
+            base_ts = m_samples_desc_index < m_samples_desc.size() ?
                         m_samples_desc[m_samples_desc_index]->info.capture_time : 0;
     }
-    else
-        m_base_ts = 0;
+    //the samples of the current loop are scheduled after the previous loops
+    base_ts += m_loop_time_offset;
+    {
+        std::lock_guard<std::mutex> time_base_guard(m_time_base_mutex);
+        m_time_base.sys_time = std::chrono::steady_clock::now();
+        m_time_base.ts = base_ts;
+        m_time_base.speed = m_playback_speed;
+    }
+    m_last_notified_ts = base_ts;
 
-    LOG_VERBOSE("new time base - " << m_base_ts);
+    LOG_VERBOSE("new time base - " << base_ts);
 }
 
 file_types::version disk_read_base::query_sdk_version()
@@ -573,29 +1008,118 @@ file_types::version disk_read_base::query_librealsense_version()
 
 std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std::shared_ptr<file_types::frame_sample> &frame)
 {
-    status sts = m_file_data_read->set_position(frame->info.offset, move_method::begin);
+    auto rv = m_frame_cache.get(frame->finfo.stream, frame->finfo.index_in_stream);
+    if(rv)
+        return rv;
 
     if(!m_decoder)
         init_decoder();
 
+    rv = read_image_buffer(frame, *m_file_data_read, *m_decoder, m_encoded_data);
+    m_frame_cache.put(frame->finfo.stream, frame->finfo.index_in_stream, rv);
+    return rv;
+}
+
+bool disk_read_base::query_sample_extent(const std::shared_ptr<file_types::frame_sample> &frame, file & data_file, uint64_t & extent)
+{
+    //the sample data ends where the next indexed sample begins, the last sample ends at the end of the file
+    auto & indices = m_image_indices.at(frame->finfo.stream);
+    if(frame->finfo.index_in_stream >= indices.size())
+        return false;
+    auto sample_index = indices[frame->finfo.index_in_stream];
+    //the completion is read before the samples count, so a complete index has all its samples
+    bool is_index_complete = m_is_index_complete;
+    uint64_t end = 0;
+    if(m_samples_desc.size() >= sample_index + 2)
+        end = m_samples_desc[sample_index + 1]->info.offset;
+    else if(is_index_complete)
+    {
+        if(data_file.set_position(0, move_method::end, &end) != status::status_no_error)
+            return false;
+    }
+    //the next sample isn't indexed yet, the extent is found by the sample chunks headers rather than waiting for the indexing thread
+    else if(!query_sample_chunks_end(frame, data_file, end))
+        return false;
+    if(end <= frame->info.offset)
+        return false;
+    extent = end - frame->info.offset;
+    return true;
+}
+
+bool disk_read_base::query_sample_chunks_end(const std::shared_ptr<file_types::frame_sample> &frame, file & data_file, uint64_t & end)
+{
+    //walks the sample chunks headers up to the end of the sample data chunk
+    end = frame->info.offset;
+    file_types::chunk_info chunk = {};
+    for(;;)
+    {
+        if(data_file.set_position(end, move_method::begin) != status::status_no_error)
+            return false;
+        uint32_t num_bytes_read = 0;
+        data_file.read_bytes(&chunk, sizeof(chunk), num_bytes_read);
+        if(num_bytes_read != sizeof(chunk) || chunk.size == 0)
+            return false;
+        end += sizeof(chunk) + chunk.size;
+        if(chunk.id == file_types::chunk_id::chunk_sample_data)
+            return true;
+    }
+}
+
+std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std::shared_ptr<file_types::frame_sample> &frame, file & data_file,
+                                                                            compression::decoder & decoder, std::vector<uint8_t> & encoded_data)
+{
+    uint64_t extent = 0;
+    if(!query_sample_extent(frame, data_file, extent))
+        return nullptr;
+
+    status sts = data_file.set_position(frame->info.offset, move_method::begin);
+
     if(sts != status::status_no_error)
         return nullptr;
 
+    //the samples descriptors are shared between the readers, the metadata is read into a copy
+    auto sample = std::make_shared<file_types::frame_sample>(frame.get());
+
+    //fetch all the sample chunks with a single read and parse them in memory.
+    //uncompressed images are returned in place, compressed images are read to the decoding buffer.
+    uint8_t * buffer = nullptr;
+    if(sample->finfo.ctype == file_types::compression_type::none)
+    {
+        buffer = new uint8_t[extent];
+    }
+    else
+    {
+        if(encoded_data.size() < extent)
+            encoded_data.resize(extent);
+        buffer = encoded_data.data();
+    }
+    auto buffer_releaser = std::unique_ptr<uint8_t[]>(sample->finfo.ctype == file_types::compression_type::none ? buffer : nullptr);
+
     uint32_t num_bytes_read = 0;
-    unsigned long num_bytes_to_read = 0;
+    data_file.read_bytes(buffer, static_cast<uint32_t>(extent), num_bytes_read);
+    if(num_bytes_read != extent)
+    {
+        LOG_ERROR("failed to read sample data, sample offset - " << frame->info.offset);
+        return nullptr;
+    }
 
+    uint8_t * position = buffer;
+    uint8_t * buffer_end = buffer + extent;
     file_types::chunk_info chunk = {};
-    for (;;)
+    while(position + sizeof(chunk) <= buffer_end)
     {
-        m_file_data_read->read_bytes(&chunk, sizeof(chunk), num_bytes_read);
-        num_bytes_to_read = chunk.size;
+        memcpy(&chunk, position, sizeof(chunk));
+        position += sizeof(chunk);
+        unsigned long num_bytes_to_read = chunk.size;
+        if(num_bytes_to_read > static_cast<unsigned long>(buffer_end - position))
+            break;
         switch (chunk.id)
         {
             case file_types::chunk_id::chunk_image_metadata:
             {
                 if(num_bytes_to_read > 0)
                 {
-                    read_frame_metadata(frame, num_bytes_to_read);
+                    read_frame_metadata(sample, position, num_bytes_to_read);
                 }
                 else
                 {
@@ -605,27 +1129,22 @@ std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std:
             }
             case file_types::chunk_id::chunk_sample_data:
             {
-                m_file_data_read->set_position(size_of_pitches(),move_method::current);
+                uint8_t * data = position + size_of_pitches();
                 num_bytes_to_read -= size_of_pitches();
-                switch (frame->finfo.ctype)
+                switch (sample->finfo.ctype)
                 {
                     case file_types::compression_type::none:
                     {
+                        auto block = buffer_releaser.release();
                         auto rv = std::shared_ptr<file_types::frame_sample>(
-                        new file_types::frame_sample(frame.get()), [](file_types::frame_sample* f) { delete[] f->data; delete f;});
-                        auto data = new uint8_t[num_bytes_to_read];
-                        m_file_data_read->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
-                        num_bytes_to_read -= num_bytes_read;
+                        new file_types::frame_sample(sample.get()), [block](file_types::frame_sample* f) { delete[] block; delete f;});
                         rv->data = data;
                         return rv;
                     }
                     case file_types::compression_type::lz4:
                     case file_types::compression_type::h264:
                     {
-                        uint8_t * data = m_encoded_data.data();
-                        m_file_data_read->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
-                        num_bytes_to_read -= num_bytes_read;
-                        auto rv = m_decoder->decode_frame(frame, data, num_bytes_read);
+                        auto rv = decoder.decode_frame(sample, data, static_cast<uint32_t>(num_bytes_to_read));
                         return rv;
                     }
                     default:
@@ -633,19 +1152,15 @@ std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std:
                         throw std::runtime_error("unsupported compression type");
                     }
                 }
-                if (num_bytes_to_read > 0)
-                {
-                    LOG_ERROR("image size failed to match the data size");
-                }
-                return nullptr;
             }
             default:
             {
                 if(num_bytes_to_read == 0)
                     return nullptr;
-                m_file_data_read->set_position(num_bytes_to_read, move_method::current);
             }
-            num_bytes_to_read = 0;
         }
+        position += num_bytes_to_read;
     }
+    LOG_ERROR("image size failed to match the data size");
+    return nullptr;
 }
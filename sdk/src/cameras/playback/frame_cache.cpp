@@ -0,0 +1,82 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "frame_cache.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+        frame_cache::frame_cache(uint64_t capacity) : m_size(0), m_capacity(capacity)
+        {
+
+        }
+
+        std::shared_ptr<file_types::frame_sample> frame_cache::get(rs_stream stream, uint32_t index)
+        {
+            if(m_capacity == 0)
+                return nullptr;
+            std::lock_guard<std::mutex> guard(m_mutex);
+            auto it = m_lookup.find(key(stream, index));
+            if(it == m_lookup.end())
+                return nullptr;
+            //move the entry to the front of the list, the iterators stay valid
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->frame;
+        }
+
+        void frame_cache::put(rs_stream stream, uint32_t index, std::shared_ptr<file_types::frame_sample> frame)
+        {
+            if(!frame || m_capacity == 0)
+                return;
+            uint64_t size = static_cast<uint64_t>(frame->finfo.stride) * static_cast<uint64_t>(frame->finfo.height);
+
+            std::lock_guard<std::mutex> guard(m_mutex);
+            if(size > m_capacity)
+                return;
+            auto id = key(stream, index);
+            auto it = m_lookup.find(id);
+            if(it != m_lookup.end())
+            {
+                m_size -= it->second->size;
+                m_entries.erase(it->second);
+                m_lookup.erase(it);
+            }
+            evict(m_capacity - size);
+            m_entries.push_front({id, frame, size});
+            m_lookup[id] = m_entries.begin();
+            m_size += size;
+        }
+
+        void frame_cache::set_capacity(uint64_t capacity)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_capacity = capacity;
+            evict(m_capacity);
+        }
+
+        uint64_t frame_cache::get_capacity()
+        {
+            return m_capacity;
+        }
+
+        void frame_cache::clear()
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            evict(0);
+        }
+
+        void frame_cache::evict(uint64_t capacity)
+        {
+            while(m_size > capacity && !m_entries.empty())
+            {
+                auto & last = m_entries.back();
+                m_size -= last.size;
+                m_lookup.erase(last.id);
+                m_entries.pop_back();
+            }
+        }
+    }
+}
@@ -0,0 +1,94 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "frame_reader.h"
+#include "rs/utils/librealsense_conversion_utils.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+        namespace
+        {
+            //keeps the decoded frame alive for the image lifetime
+            class frame_data_releaser : public rs::utils::release_self_base<rs::core::release_interface>
+            {
+            public:
+                frame_data_releaser(std::shared_ptr<file_types::frame_sample> frame) : m_frame(frame) {}
+            protected:
+                ~frame_data_releaser() {}
+            private:
+                std::shared_ptr<file_types::frame_sample> m_frame;
+            };
+        }
+
+        frame_reader::frame_reader(disk_read_interface * disk_read) : m_disk_read(disk_read)
+        {
+
+        }
+
+        rs::core::image_interface * frame_reader::read(rs::stream stream, uint32_t index)
+        {
+            auto streams_infos = m_disk_read->get_streams_infos();
+            if(streams_infos.find(static_cast<rs_stream>(stream)) == streams_infos.end())
+                return nullptr;
+
+            auto context = acquire_context();
+            if(!context)
+            {
+                LOG_ERROR("failed to create frame read context");
+                return nullptr;
+            }
+            auto frame = m_disk_read->read_frame(static_cast<rs_stream>(stream), index, *context);
+            return_context(std::move(context));
+            if(!frame)
+                return nullptr;
+
+            image_info info = {};
+            info.width = frame->finfo.width;
+            info.height = frame->finfo.height;
+            info.format = rs::utils::convert_pixel_format(static_cast<rs::format>(frame->finfo.format));
+            info.pitch = frame->finfo.stride;
+
+            return image_interface::create_instance_from_raw_data(&info,
+                                                                  image_interface::image_data_with_data_releaser(frame->data, new frame_data_releaser(frame)),
+                                                                  rs::utils::convert_stream_type(stream),
+                                                                  image_interface::flag::any,
+                                                                  frame->finfo.time_stamp,
+                                                                  frame->finfo.number,
+                                                                  rs::utils::convert_timestamp_domain(static_cast<rs::timestamp_domain>(frame->finfo.time_stamp_domain)));
+        }
+
+        int frame_reader::get_frame_count(rs::stream stream)
+        {
+            auto streams_infos = m_disk_read->get_streams_infos();
+            if(streams_infos.find(static_cast<rs_stream>(stream)) == streams_infos.end())
+                return 0;
+            return m_disk_read->query_number_of_frames(static_cast<rs_stream>(stream));
+        }
+
+        std::unique_ptr<image_read_context> frame_reader::acquire_context()
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                if(!m_contexts.empty())
+                {
+                    auto context = std::move(m_contexts.back());
+                    m_contexts.pop_back();
+                    return context;
+                }
+            }
+            //all contexts are in use by other threads, open another one
+            return m_disk_read->create_image_read_context();
+        }
+
+        void frame_reader::return_context(std::unique_ptr<image_read_context> context)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_contexts.push_back(std::move(context));
+        }
+    }
+}
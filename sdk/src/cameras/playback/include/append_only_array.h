@@ -0,0 +1,67 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <stdint.h>
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+        * @brief Growing array with a single writer and multiple lock-free readers.
+        *
+        * Elements are stored in fixed size blocks which are never reallocated, so a reference to an element stays valid
+        * while the array keeps growing. An element is published to the readers only after it was fully written,
+        * readers may access any index lower than the value returned by size() without any locking.
+        * Elements can't be modified or removed once they were published.
+        */
+        template <class T, uint32_t BLOCK_BITS = 12, uint32_t MAX_BLOCKS = (1 << 14)>
+        class append_only_array
+        {
+        public:
+            append_only_array() : m_blocks(new std::unique_ptr<T[]>[MAX_BLOCKS]), m_size(0) {}
+
+            append_only_array(const append_only_array&) = delete;
+            append_only_array& operator=(const append_only_array&) = delete;
+
+            //writer thread only
+            void push_back(const T& value)
+            {
+                uint32_t size = m_size.load(std::memory_order_relaxed);
+                uint32_t block = size >> BLOCK_BITS;
+                if(block >= MAX_BLOCKS)
+                    throw std::out_of_range("append only array is full");
+                if(!m_blocks[block])
+                    m_blocks[block].reset(new T[BLOCK_SIZE]);
+                m_blocks[block][size & (BLOCK_SIZE - 1)] = value;
+                m_size.store(size + 1, std::memory_order_release);
+            }
+
+            uint32_t size() const { return m_size.load(std::memory_order_acquire); }
+
+            bool empty() const { return size() == 0; }
+
+            const T& operator[](uint32_t index) const
+            {
+                return m_blocks[index >> BLOCK_BITS][index & (BLOCK_SIZE - 1)];
+            }
+
+            const T& at(uint32_t index) const
+            {
+                if(index >= size())
+                    throw std::out_of_range("append only array index is out of range");
+                return (*this)[index];
+            }
+
+        private:
+            static const uint32_t BLOCK_SIZE = 1 << BLOCK_BITS;
+
+            std::unique_ptr<std::unique_ptr<T[]>[]> m_blocks;
+            std::atomic<uint32_t>                   m_size;
+        };
+    }
+}
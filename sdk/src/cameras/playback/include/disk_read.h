@@ -11,13 +11,14 @@ namespace rs
         class disk_read : public disk_read_base
         {
         public:
-            disk_read(const char *file_name) : disk_read_base(file_name) {}
+            disk_read(const char *file_name, std::shared_ptr<disk_read_interface> recording = nullptr) : disk_read_base(file_name, recording) {}
             virtual ~disk_read(void);
+            virtual std::unique_ptr<disk_read_interface> create_view() override { return std::unique_ptr<disk_read_interface>(new disk_read(m_file_path.c_str(), query_recording())); }
         protected:
             virtual rs::core::status read_headers() override;
             virtual void index_next_samples(uint32_t number_of_samples) override;
             virtual int32_t size_of_pitches(void) override;
-            virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, unsigned long num_bytes_to_read) override;
+            virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, const uint8_t * data, unsigned long num_bytes_to_read) override;
         };
     }
 }
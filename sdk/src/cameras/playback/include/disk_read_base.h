@@ -9,11 +9,13 @@
 #include <mutex>
 #include <thread>
 #include <chrono>
-#include "compression/decoder.h"
+#include <atomic>
+#include <condition_variable>
 #include "include/file_types.h"
 #include "status.h"
 #include "disk_read_interface.h"
-#include "include/file.h"
+#include "append_only_array.h"
+#include "frame_cache.h"
 
 namespace rs
 {
@@ -24,12 +26,49 @@ namespace rs
             struct active_stream_info
             {
                 core::file_types::stream_info   m_stream_info;
-                std::vector<uint32_t>           m_image_indices;
                 uint32_t                        m_prefetched_samples_count;
             };
 
+            struct timing_accumulator
+            {
+                uint64_t    count;
+                double      delay_sum;
+                double      delay_square_sum;
+                double      max_delay;
+                double      last_delay;
+                double      jitter_sum;
+                double      max_jitter;
+            };
+
+            //the real time schedule of the samples, a sample is due when the recorded time since ts, scaled by the speed, passed since sys_time
+            struct time_base
+            {
+                std::chrono::steady_clock::time_point sys_time;
+                uint64_t                              ts;
+                double                                speed;
+            };
+
+            //the samples index of a recording, shared by the reader which indexes the file and all the views of the recording.
+            //the index is written only by the indexing thread, readers wait until the range they need is available.
+            //all streams entries are created before indexing starts, the map itself is not modified while indexing.
+            struct samples_index
+            {
+                samples_index() : is_complete(false), frames(DEFAULT_FRAME_CACHE_SIZE)
+                {
+                    for(int32_t stream = 0; stream < rs_stream::RS_STREAM_COUNT; stream++)
+                        image_indices[static_cast<rs_stream>(stream)];
+                }
+
+                std::map<rs_stream, append_only_array<uint32_t, 12, (1 << 10)>> image_indices;
+                append_only_array<std::shared_ptr<core::file_types::sample>>    samples_desc;
+                std::atomic<bool>                                               is_complete;
+                std::mutex                                                      mutex;
+                std::condition_variable                                         cv; //signaled when new samples are indexed
+                frame_cache                                                     frames;
+            };
+
         public:
-            disk_read_base(const char *file_path);
+            disk_read_base(const char *file_path, std::shared_ptr<disk_read_interface> recording = nullptr);
             virtual ~disk_read_base(void);
             virtual core::status init() override;
             virtual void reset() override;
@@ -39,9 +78,25 @@ namespace rs
             virtual bool is_motion_tracking_enabled() override { return m_is_motion_tracking_enabled; }
             virtual void enable_motions_callback(bool state) override;
             virtual void set_realtime(bool realtime) override;
+            virtual bool set_playback_speed(double speed) override;
+            virtual double query_playback_speed() override { return m_playback_speed; }
+            virtual double query_achieved_playback_speed() override;
+            virtual playback::timing_stats query_timing_stats() override;
+            virtual void set_frame_cache_size(uint64_t size) override { m_frame_cache.set_capacity(size); }
+            virtual uint64_t query_frame_cache_size() override { return m_frame_cache.get_capacity(); }
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_index(uint32_t index, rs_stream stream_type) override;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_time_stamp(uint64_t ts) override;
+            virtual std::unique_ptr<image_read_context> create_image_read_context() override;
+            virtual std::shared_ptr<core::file_types::frame_sample> read_frame(rs_stream stream, uint32_t index, image_read_context & context) override;
+            virtual std::shared_ptr<core::file_types::sample> read_sample(uint32_t index, image_read_context & context) override;
+            virtual uint32_t query_number_of_samples() override;
             virtual bool query_realtime() override { return m_realtime; }
+            virtual void set_reverse(bool reverse) override;
+            virtual bool query_reverse() override { return m_reverse; }
+            virtual bool set_playback_range(uint64_t start_time, uint64_t end_time) override;
+            virtual void set_loop(bool loop) override { m_loop = loop; }
+            virtual bool query_loop() override { return m_loop; }
+            virtual uint32_t query_loop_count() override { return m_loop_count; }
             virtual bool is_stream_profile_available(rs_stream stream, int width, int height, rs_format format, int framerate) override;
             virtual uint32_t query_number_of_frames(rs_stream stream_type) override;
             virtual int32_t query_coordinate_system() override { return m_file_header.coordinate_system; }
@@ -60,10 +115,21 @@ namespace rs
             virtual void update_imu_drop_count(uint32_t drop_count)override;
 
         protected:
+            std::shared_ptr<disk_read_interface> query_recording();
             virtual rs::core::status read_headers() = 0;
             virtual void index_next_samples(uint32_t number_of_samples) = 0;
+            void start_indexing();
+            void stop_indexing();
+            void index_thread();
+            void verify_number_of_frames();
+            bool wait_for_samples(uint32_t number_of_samples);
+            bool wait_for_frames(rs_stream stream, uint32_t number_of_frames);
             virtual int32_t size_of_pitches(void) = 0;
             virtual std::shared_ptr<core::file_types::frame_sample> read_image_buffer(std::shared_ptr<rs::core::file_types::frame_sample> &frame);
+            std::shared_ptr<core::file_types::frame_sample> read_image_buffer(std::shared_ptr<rs::core::file_types::frame_sample> &frame, core::file & data_file,
+                                                                              core::compression::decoder & decoder, std::vector<uint8_t> & encoded_data);
+            bool query_sample_extent(const std::shared_ptr<core::file_types::frame_sample> &frame, core::file & data_file, uint64_t & extent);
+            bool query_sample_chunks_end(const std::shared_ptr<core::file_types::frame_sample> &frame, core::file & data_file, uint64_t & end);
             void read_thread();
             core::file_types::version query_sdk_version();
             core::file_types::version query_librealsense_version();
@@ -72,36 +138,75 @@ namespace rs
             void prefetch_sample();
             bool read_next_sample();
             void update_time_base();
+            time_base query_time_base();
+            void loop_to_range_start();
+            std::shared_ptr<core::file_types::sample> shift_sample_time(const std::shared_ptr<core::file_types::sample> & sample);
             std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> find_nearest_frames(uint32_t sample_index, rs_stream stream);
             bool all_samples_bufferd();
+            bool has_samples_to_prefetch();
             void init_decoder();
-            virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, unsigned long num_bytes_to_read) = 0;
+            static void create_decoder(const std::map<rs_stream, core::file_types::stream_info> & streams_infos,
+                                       std::shared_ptr<core::compression::decoder> & decoder, std::vector<uint8_t> & encoded_data);
+            virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, const uint8_t * data, unsigned long num_bytes_to_read) = 0;
+            std::chrono::steady_clock::time_point calc_deadline(std::shared_ptr<core::file_types::sample> sample);
             int64_t calc_sleep_time(std::shared_ptr<core::file_types::sample> sample);
+            void sleep_until(std::chrono::steady_clock::time_point deadline);
+            void update_timing_stats(int64_t delay);
+            bool is_frame_late(std::shared_ptr<core::file_types::frame_sample> frame);
 
             playback::capture_mode get_capture_mode();
 
-            static const int                                                NUMBER_OF_SAMPLES_TO_INDEX = 1;
+            static const int                                                NUMBER_OF_SAMPLES_TO_INDEX = 16;
+
+            static const int                                                INDEXING_THREAD_NICE_VALUE = 10;
 
             //if IMU and video streams are enabled no more than 4 images will be bufferd per stream
             static const int                                                NUMBER_OF_REQUIRED_PREFETCHED_SAMPLES = 20;
 
+            static constexpr double                                         MIN_PLAYBACK_SPEED = 0.1;
+            static constexpr double                                         MAX_PLAYBACK_SPEED = 32.0;
+
+            //the forward streaming reads each frame once, the cache is enabled by the applications which revisit frames
+            static const uint64_t                                           DEFAULT_FRAME_CACHE_SIZE = 0;
+
+            //the read thread wakes up before a sample deadline by the measured wake up latency of its sleeps, up to this long,
+            //and spins for the remaining time
+            static const int64_t                                            MAX_DEADLINE_SPIN_TIME_US = 200;
+
             std::string                                                     m_file_path;
+            std::shared_ptr<disk_read_interface>                            m_recording; // the indexing reader of a view, null if this reader indexes the file
+            std::shared_ptr<samples_index>                                  m_index;
             //file pointers
             std::unique_ptr<core::file>                                     m_file_indexing;//use only for samples indexing
             std::unique_ptr<core::file>                                     m_file_data_read;//use both for file header read and image data read
 
             bool                                                            m_pause;
             bool                                                            m_realtime;
-            bool                                                            m_is_index_complete;
+            std::atomic<bool>                                               m_reverse;
+            std::atomic<bool>                                               m_loop;
+            std::atomic<bool> &                                             m_is_index_complete;
+            std::atomic<bool>                                               m_stop_indexing;
 
             std::mutex                                                      m_mutex;
             std::thread                                                     m_thread;
+            std::thread                                                     m_index_thread;
+            std::mutex &                                                    m_index_mutex;
+            std::condition_variable &                                       m_index_cv; //signaled when new samples are indexed
 
             std::shared_ptr<core::compression::decoder>                     m_decoder;
             std::vector<uint8_t>                                            m_encoded_data;
-
-            std::chrono::high_resolution_clock::time_point                  m_base_sys_time;
-            uint64_t                                                        m_base_ts;
+            frame_cache &                                                   m_frame_cache; // decoded frames, shared by the streaming, seeks, frame readers and views
+
+            //the time base is updated by the calling thread and read by the read thread without holding m_mutex, which is held while
+            //the samples callbacks run. its members are read and written together under their own lock, so a deadline never mixes two time bases
+            std::mutex                                                      m_time_base_mutex;
+            time_base                                                       m_time_base; // the deadlines of all samples are relative to it, guarded by m_time_base_mutex
+            std::atomic<double>                                             m_playback_speed; // the requested speed, applied by the next time base update
+            std::atomic<uint64_t>                                           m_last_notified_ts; // capture time of the last sample indicated to the device
+            //the timing stats are queried by the application while m_mutex is held by the sample callbacks, they have their own lock
+            std::mutex                                                      m_timing_mutex;
+            timing_accumulator                                              m_timing; // real time delivery delays since the time base update, guarded by m_timing_mutex
+            int64_t                                                         m_wake_up_latency; // recent wake up latency of the read thread sleeps in microseconds, used by the read thread only
 
             //file static info
             core::file_types::sw_info                                       m_sw_info;
@@ -114,11 +219,16 @@ namespace rs
             std::map<rs_camera_info, std::string>                           m_camera_info;
             bool                                                            m_is_motion_tracking_enabled;
 
-            //sticky variables, calculated once in objects lifetime
-            std::map<rs_stream, std::vector<uint32_t>>                      m_image_indices; // index in m_samples_descriptors
+            //sticky variables, calculated once in objects lifetime, shared with the views through m_index
+            std::map<rs_stream, append_only_array<uint32_t, 12, (1 << 10)>> & m_image_indices; // index in m_samples_descriptors
             std::queue<std::shared_ptr<core::file_types::sample>>           m_prefetched_samples;
-            std::vector<std::shared_ptr<core::file_types::sample>>          m_samples_desc; // growing vector of all samples descriptors in order of capture
-            uint32_t                                                        m_samples_desc_index; // points to the nexr indexed sample, which wasn't prefetched yet
+            append_only_array<std::shared_ptr<core::file_types::sample>> &  m_samples_desc; // growing array of all samples descriptors in order of capture
+            uint32_t                                                        m_samples_desc_index; // points to the nexr indexed sample, which wasn't prefetched yet. in reverse playback points one past it
+            uint32_t                                                        m_last_notified_index; // one past the index of the last indicated frame, 0 if no frame was indicated
+            uint64_t                                                        m_range_end_time; // capture time after which the forward playback ends
+            uint32_t                                                        m_range_first_index; // index of the first sample of the playback range, where the reverse playback ends
+            std::atomic<uint32_t>                                           m_loop_count; // number of times the playback wrapped to the range start
+            uint64_t                                                        m_loop_time_offset; // added to the capture time of the samples of the current loop, guarded by m_mutex
 
             std::function<void(std::shared_ptr<core::file_types::sample>)>  m_sample_callback;
             std::function<void()>                                           m_eof_callback;
@@ -60,6 +60,14 @@ namespace rs
                 LOG_ERROR("failed to create disk read")
                 return rs::core::status_file_read_failed;
             }
+
+            static rs::core::status create_disk_read_view(const std::shared_ptr<disk_read_interface> &recording, std::unique_ptr<disk_read_interface> &disk_read)
+            {
+                if(!recording) return rs::core::status_file_open_failed;
+                LOG_INFO("create disk read view of a shared recording")
+                disk_read = recording->create_view();
+                return disk_read->init();
+            }
         };
     }
 }
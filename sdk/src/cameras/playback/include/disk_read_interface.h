@@ -6,6 +6,8 @@
 #include <map>
 #include <memory>
 #include "include/file_types.h"
+#include "include/file.h"
+#include "compression/decoder.h"
 #include "rs/playback/playback_device.h"
 #include "status.h"
 
@@ -13,12 +15,27 @@ namespace rs
 {
     namespace playback
     {
-        class disk_read_interface
+        /**
+        * @brief File handle, decoder and decoding buffer used to read image samples data.
+        *
+        * Each thread which reads image data concurrently to the streaming owns a separate instance.
+        */
+        struct image_read_context
+        {
+            std::unique_ptr<core::file>                     file;
+            std::shared_ptr<core::compression::decoder>     decoder;
+            std::vector<uint8_t>                            encoded_data;
+        };
+
+        class disk_read_interface : public std::enable_shared_from_this<disk_read_interface>
         {
         public:
             disk_read_interface() {}
             virtual ~disk_read_interface(void) {}
             virtual core::status init() = 0;
+            //creates an uninitialized reader of the same recording, which shares the samples index and the frames cache of this reader.
+            //this reader must be owned by a shared pointer.
+            virtual std::unique_ptr<disk_read_interface> create_view() = 0;
             virtual void reset() = 0;
             virtual void resume() = 0;
             virtual void pause() = 0;
@@ -31,9 +48,25 @@ namespace rs
             virtual std::vector<rs_capabilities> get_capabilities() = 0;
             virtual std::map<rs_option, double> get_properties() = 0;
             virtual void set_realtime(bool realtime) = 0;
+            virtual bool set_playback_speed(double speed) = 0;
+            virtual double query_playback_speed() = 0;
+            virtual double query_achieved_playback_speed() = 0;
+            virtual playback::timing_stats query_timing_stats() = 0;
+            virtual void set_frame_cache_size(uint64_t size) = 0;
+            virtual uint64_t query_frame_cache_size() = 0;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_index(uint32_t index, rs_stream stream_type) = 0;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_time_stamp(uint64_t ts) = 0;
+            virtual std::unique_ptr<image_read_context> create_image_read_context() = 0;
+            virtual std::shared_ptr<core::file_types::frame_sample> read_frame(rs_stream stream, uint32_t index, image_read_context & context) = 0;
+            virtual std::shared_ptr<core::file_types::sample> read_sample(uint32_t index, image_read_context & context) = 0;
+            virtual uint32_t query_number_of_samples() = 0;
             virtual bool query_realtime() = 0;
+            virtual void set_reverse(bool reverse) = 0;
+            virtual bool set_playback_range(uint64_t start_time, uint64_t end_time) = 0;
+            virtual void set_loop(bool loop) = 0;
+            virtual bool query_loop() = 0;
+            virtual uint32_t query_loop_count() = 0;
+            virtual bool query_reverse() = 0;
             virtual uint32_t query_number_of_frames(rs_stream stream_type) = 0;
             virtual int32_t query_coordinate_system() = 0;
             virtual core::file_types::version query_sdk_version() = 0;
@@ -0,0 +1,52 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "include/file_types.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+        * @brief Least recently used cache of decoded frames, keyed by stream type and frame index in the stream.
+        *
+        * The cache is bounded by the total size of the cached images data, the least recently used frames are evicted
+        * once the size exceeds the cache capacity. A zero capacity disables the cache, a disabled cache doesn't take its lock.
+        * The cache is thread safe.
+        */
+        class frame_cache
+        {
+        public:
+            frame_cache(uint64_t capacity);
+
+            std::shared_ptr<core::file_types::frame_sample> get(rs_stream stream, uint32_t index);
+            void put(rs_stream stream, uint32_t index, std::shared_ptr<core::file_types::frame_sample> frame);
+            void set_capacity(uint64_t capacity);
+            uint64_t get_capacity();
+            void clear();
+
+        private:
+            typedef std::pair<rs_stream, uint32_t> key;
+            struct entry
+            {
+                key                                             id;
+                std::shared_ptr<core::file_types::frame_sample> frame;
+                uint64_t                                        size;
+            };
+
+            void evict(uint64_t capacity);
+
+            std::mutex                                          m_mutex;
+            std::list<entry>                                    m_entries; // most recently used first
+            std::map<key, std::list<entry>::iterator>           m_lookup;
+            uint64_t                                            m_size;
+            std::atomic<uint64_t>                               m_capacity; // written under m_mutex
+        };
+    }
+}
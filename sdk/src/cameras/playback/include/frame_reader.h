@@ -0,0 +1,36 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "rs/playback/frame_reader_interface.h"
+#include "rs/utils/release_self_base.h"
+#include "disk_read_interface.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        class frame_reader : public rs::utils::release_self_base<frame_reader_interface>
+        {
+        public:
+            frame_reader(disk_read_interface * disk_read);
+            virtual rs::core::image_interface * read(rs::stream stream, uint32_t index) override;
+            virtual int get_frame_count(rs::stream stream) override;
+
+        protected:
+            virtual ~frame_reader() {}
+
+        private:
+            std::unique_ptr<image_read_context> acquire_context();
+            void return_context(std::unique_ptr<image_read_context> context);
+
+            disk_read_interface *                               m_disk_read;
+            std::mutex                                          m_mutex;
+            //idle read contexts, a context is taken out of the pool for the duration of a single read
+            std::vector<std::unique_ptr<image_read_context>>    m_contexts;
+        };
+    }
+}
@@ -0,0 +1,142 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <stdint.h>
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+        * @brief Bounded lock-free queue of a single producer thread and a single consumer thread, where the producer may remove the oldest elements.
+        *
+        * push() and push_overwrite() are called only by the producer, pop() is called by the consumer and by the producer inside push_overwrite().
+        * The ring is not single consumer, both threads remove elements from the head: pop() advances it by a compare and swap, and each slot
+        * carries a sequence number so the two threads never remove the same element.
+        * push() and pop() don't block, push_overwrite() yields while the consumer moves the element out of the last free slot.
+        * The ring keeps the highest number of queued elements since the last reset, to let the owner tune the ring depth.
+        * reset() and clear() are not thread safe, and should be called while both threads are idle.
+        */
+        template <class T>
+        class overwrite_ring
+        {
+            struct slot
+            {
+                std::atomic<uint32_t>   sequence; // equals the position of the next push to the slot while the slot is free, one past it while it holds an element
+                T                       value;
+            };
+
+        public:
+            overwrite_ring() : m_capacity(0), m_head(0), m_tail(0), m_high_water_mark(0) {}
+
+            overwrite_ring(const overwrite_ring&) = delete;
+            overwrite_ring& operator=(const overwrite_ring&) = delete;
+
+            void reset(uint32_t capacity)
+            {
+                m_buffer.reset(capacity > 0 ? new slot[capacity] : nullptr);
+                for(uint32_t i = 0; i < capacity; i++)
+                    m_buffer[i].sequence.store(i, std::memory_order_relaxed);
+                m_capacity = capacity;
+                m_head.store(0, std::memory_order_relaxed);
+                m_tail.store(0, std::memory_order_relaxed);
+                m_high_water_mark.store(0, std::memory_order_relaxed);
+            }
+
+            void clear()
+            {
+                T value;
+                while(pop(value));
+            }
+
+            //producer thread only, returns false if the ring is full
+            bool push(T value)
+            {
+                if(m_capacity == 0)
+                    return false;
+                uint32_t tail = m_tail.load(std::memory_order_relaxed);
+                slot & tail_slot = m_buffer[tail % m_capacity];
+                if(tail_slot.sequence.load(std::memory_order_acquire) != tail)
+                    return false;
+                tail_slot.value = std::move(value);
+                tail_slot.sequence.store(tail + 1, std::memory_order_release);
+                m_tail.store(tail + 1, std::memory_order_release);
+                uint32_t count = tail + 1 - m_head.load(std::memory_order_acquire);
+                if(count > m_high_water_mark.load(std::memory_order_relaxed))
+                    m_high_water_mark.store(count, std::memory_order_relaxed);
+                return true;
+            }
+
+            //producer thread only, removes the oldest elements until the value fits, returns the number of removed elements
+            uint32_t push_overwrite(T value)
+            {
+                uint32_t removed_count = 0;
+                while(m_capacity > 0 && !push(value))
+                {
+                    T oldest;
+                    if(size() >= m_capacity)
+                    {
+                        if(pop(oldest))
+                            removed_count++;
+                    }
+                    else//the consumer is moving the last popped element out of the slot
+                        std::this_thread::yield();
+                }
+                return removed_count;
+            }
+
+            //consumer thread, or the producer thread removing the oldest element, returns false if the ring is empty
+            bool pop(T& value)
+            {
+                if(m_capacity == 0)
+                    return false;
+                uint32_t head = m_head.load(std::memory_order_relaxed);
+                while(true)
+                {
+                    slot & head_slot = m_buffer[head % m_capacity];
+                    auto distance = static_cast<int32_t>(head_slot.sequence.load(std::memory_order_acquire) - (head + 1));
+                    if(distance < 0)
+                        return false;
+                    if(distance > 0)
+                    {
+                        //the element was removed by the other thread
+                        head = m_head.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    if(m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed))
+                    {
+                        value = std::move(head_slot.value);
+                        head_slot.value = T();
+                        head_slot.sequence.store(head + m_capacity, std::memory_order_release);
+                        return true;
+                    }
+                }
+            }
+
+            bool empty() const { return size() == 0; }
+
+            uint32_t size() const
+            {
+                //the head is loaded first, it never passes the tail
+                uint32_t head = m_head.load(std::memory_order_acquire);
+                return m_tail.load(std::memory_order_acquire) - head;
+            }
+
+            uint32_t capacity() const { return m_capacity; }
+
+            uint32_t high_water_mark() const { return m_high_water_mark.load(std::memory_order_relaxed); }
+
+        private:
+            std::unique_ptr<slot[]> m_buffer;
+            uint32_t                m_capacity;
+            std::atomic<uint32_t>   m_head; // next element to pop
+            std::atomic<uint32_t>   m_tail; // next free slot, written by the producer
+            std::atomic<uint32_t>   m_high_water_mark;
+        };
+    }
+}
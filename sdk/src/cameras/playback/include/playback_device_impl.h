@@ -2,14 +2,16 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <thread>
-#include <queue>
 #include <condition_variable>
 #include "playback_device_interface.h"
+#include "rs/playback/frame_reader_interface.h"
 #include "disk_read_interface.h"
 #include "rs_stream_impl.h"
+#include "overwrite_ring.h"
 
 #ifdef WIN32 
 #ifdef realsense_playback_EXPORTS
@@ -53,22 +55,47 @@ namespace rs
             std::thread             thread;
             std::mutex              mutex;
             std::condition_variable sample_ready_cv;
+            std::atomic<bool>       consumer_waiting;
+
+            thread_sync() : consumer_waiting(false) {}
+
+            //called by the producer after a sample was pushed, takes the mutex only if the consumer is about to sleep
+            void notify_consumer()
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if(consumer_waiting.load(std::memory_order_relaxed))
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    sample_ready_cv.notify_one();
+                }
+            }
+
+            //called by the consumer once its samples queue is empty
+            template <class predicate>
+            void wait_for_sample(predicate pred)
+            {
+                std::unique_lock<std::mutex> guard(mutex);
+                consumer_waiting.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                sample_ready_cv.wait(guard, pred);
+                consumer_waiting.store(false, std::memory_order_relaxed);
+            }
         };
 
         struct frame_thread_sync : public thread_sync
         {
-            std::condition_variable                         sample_deleted_cv;
-            std::shared_ptr<core::file_types::frame_sample> sample;
-            std::shared_ptr<rs_frame_callback>              callback;
-            uint32_t                                        active_samples_count;
+            std::condition_variable                                         sample_deleted_cv;
+            overwrite_ring<std::shared_ptr<core::file_types::frame_sample>> samples;
+            std::shared_ptr<rs_frame_callback>                              callback;
+            uint32_t                                                        active_samples_count;
+            playback::callback_queue_policy                                 queue_policy; // latched on streaming start
         };
 
         struct imu_thread_sync : public thread_sync
         {
-            std::queue<std::shared_ptr<core::file_types::sample>>   samples;
-            std::shared_ptr<rs_motion_callback>                     motion_callback;
-            std::shared_ptr<rs_timestamp_callback>                  time_stamp_callback;
-            uint32_t                                                max_queue_size;
+            overwrite_ring<std::shared_ptr<core::file_types::sample>>   samples;
+            std::shared_ptr<rs_motion_callback>                         motion_callback;
+            std::shared_ptr<rs_timestamp_callback>                      time_stamp_callback;
 
             void push_sample_to_user(std::shared_ptr<core::file_types::sample> sample)
             {
@@ -90,7 +117,7 @@ namespace rs
         class DLL_EXPORT rs_device_ex : public device_interface
         {
         public:
-            rs_device_ex(const std::string &file_path);
+            rs_device_ex(const std::string &file_path, std::shared_ptr<disk_read_interface> recording = nullptr);
             virtual ~rs_device_ex();
             virtual const rs_stream_interface &     get_stream_interface(rs_stream stream) const override;
             virtual const char *                    get_name() const override;
@@ -138,10 +165,29 @@ namespace rs
             virtual bool                            set_frame_by_index(int index, rs_stream stream) override;
             virtual bool                            set_frame_by_timestamp(uint64_t timestamp) override;
             virtual void                            set_real_time(bool realtime) override;
+            virtual void                            set_reverse_playback(bool reverse) override;
+            virtual bool                            is_reverse_playback() override;
+            virtual bool                            set_playback_range(uint64_t start_time, uint64_t end_time) override;
+            virtual void                            set_loop_playback(bool loop) override;
+            virtual bool                            is_loop_playback() override;
+            virtual uint32_t                        get_loop_count() override;
+            virtual bool                            set_playback_speed(double speed) override;
+            virtual double                          get_playback_speed() override;
+            virtual double                          get_achieved_playback_speed() override;
+            virtual playback::timing_stats          get_timing_stats() override;
+            virtual void                            set_frame_cache_size(uint64_t size) override;
+            virtual uint64_t                        get_frame_cache_size() override;
+            virtual bool                            set_callback_queue_depth(uint32_t depth) override;
+            virtual uint32_t                        get_callback_queue_depth() override;
+            virtual void                            set_callback_queue_policy(playback::callback_queue_policy policy) override;
+            virtual playback::callback_queue_policy get_callback_queue_policy() override;
+            virtual uint32_t                        get_callback_queue_high_water_mark(rs_stream stream) override;
+            virtual uint32_t                        get_motion_callback_queue_high_water_mark() override;
             virtual int                             get_frame_index(rs_stream stream) override;
             virtual int                             get_frame_count(rs_stream stream) override;
             virtual int                             get_frame_count() override;
             virtual playback::file_info             get_file_info() override;
+            frame_reader_interface *                create_frame_reader();
 
         private:
             bool                                    all_streams_available();
@@ -158,8 +204,11 @@ namespace rs
             void                                    internal_pause();
 
             static const int                                                    LIBREALSENSE_IMU_BUFFER_SIZE = 12;
+            static const uint32_t                                               DEFAULT_CALLBACK_QUEUE_DEPTH = 4;
+            static const uint32_t                                               MAX_CALLBACK_QUEUE_DEPTH = 256;
 
             bool                                                                m_wait_streams_request;
+            std::condition_variable                                             m_wait_streams_request_cv; //signaled when wait_for_frames requests the next frames, guarded by m_mutex
             std::condition_variable                                             m_all_stream_available_cv;
             std::mutex                                                          m_all_stream_available_mutex;
             bool                                                                m_is_streaming;
@@ -171,7 +220,10 @@ namespace rs
             std::map<rs_stream, frame_thread_sync>                              m_frame_thread;
             imu_thread_sync                                                     m_imu_thread;
             std::unique_ptr<disk_read_interface>                                m_disk_read;
+            std::shared_ptr<disk_read_interface>                                m_recording; // the shared recording of a device view, null if the device reads the file by itself
             size_t                                                              m_enabled_streams_count;
+            uint32_t                                                            m_callback_queue_depth;
+            playback::callback_queue_policy                                     m_callback_queue_policy;
         };
     }
 }
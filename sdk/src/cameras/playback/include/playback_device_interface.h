@@ -31,6 +31,24 @@ namespace rs
             virtual bool set_frame_by_index(int index, rs_stream stream) = 0;
             virtual bool set_frame_by_timestamp(uint64_t timestamp) = 0;
             virtual void set_real_time(bool realtime) = 0;
+            virtual void set_reverse_playback(bool reverse) = 0;
+            virtual bool is_reverse_playback() = 0;
+            virtual bool set_playback_range(uint64_t start_time, uint64_t end_time) = 0;
+            virtual void set_loop_playback(bool loop) = 0;
+            virtual bool is_loop_playback() = 0;
+            virtual uint32_t get_loop_count() = 0;
+            virtual bool set_playback_speed(double speed) = 0;
+            virtual double get_playback_speed() = 0;
+            virtual double get_achieved_playback_speed() = 0;
+            virtual playback::timing_stats get_timing_stats() = 0;
+            virtual void set_frame_cache_size(uint64_t size) = 0;
+            virtual uint64_t get_frame_cache_size() = 0;
+            virtual bool set_callback_queue_depth(uint32_t depth) = 0;
+            virtual uint32_t get_callback_queue_depth() = 0;
+            virtual void set_callback_queue_policy(playback::callback_queue_policy policy) = 0;
+            virtual playback::callback_queue_policy get_callback_queue_policy() = 0;
+            virtual uint32_t get_callback_queue_high_water_mark(rs_stream stream) = 0;
+            virtual uint32_t get_motion_callback_queue_high_water_mark() = 0;
             virtual int get_frame_index(rs_stream stream) = 0;
             virtual int get_frame_count(rs_stream stream) = 0;
             virtual int get_frame_count() = 0;
@@ -16,8 +16,9 @@ namespace rs
                 {
 
                 public:
-                    disk_read(const char *file_name) : disk_read_base(file_name), m_time_stamp_base(0) {}
+                    disk_read(const char *file_name, std::shared_ptr<disk_read_interface> recording = nullptr) : disk_read_base(file_name, recording), m_time_stamp_base(0) {}
                     virtual ~disk_read(void);
+                    virtual std::unique_ptr<disk_read_interface> create_view() override { return std::unique_ptr<disk_read_interface>(new disk_read(m_file_path.c_str(), query_recording())); }
 
                 protected:
                     virtual rs::core::status read_headers() override;
@@ -25,7 +26,7 @@ namespace rs
                     virtual int32_t size_of_pitches(void) override;
                     void handle_ds_projection(std::vector<uint8_t> &projection_data);
                     rs::core::status get_image_offset(rs_stream stream, int64_t & offset);
-                    virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, unsigned long num_bytes_to_read) override;
+                    virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, const uint8_t * data, unsigned long num_bytes_to_read) override;
                 private:
                     uint64_t m_time_stamp_base;
                 };
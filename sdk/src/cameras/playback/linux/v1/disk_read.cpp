@@ -21,6 +21,7 @@ namespace rs
                 {
                     LOG_FUNC_SCOPE();
                     pause();
+                    stop_indexing();
                 }
 
                 core::status disk_read::read_headers()
@@ -122,8 +123,6 @@ namespace rs
                 {
                     if (m_is_index_complete) return;
 
-                    std::lock_guard<std::mutex> guard(m_mutex);
-
                     for (uint32_t index = 0; index < number_of_samples;)
                     {
                         core::file_types::chunk_info chunk = {};
@@ -165,8 +164,10 @@ namespace rs
                                         if (data_read_status != core::status_no_error)
                                             break;
                                         frame_info.index_in_stream = static_cast<uint32_t>(m_image_indices[frame_info.stream].size());
-                                        m_image_indices[frame_info.stream].push_back(static_cast<uint32_t>(m_samples_desc.size()));
+                                        //the descriptor is published before the stream index which points to it, the readers use the stream indices without locking
+                                        auto sample_index = static_cast<uint32_t>(m_samples_desc.size());
                                         m_samples_desc.push_back(std::make_shared<core::file_types::frame_sample>(frame_info, sample_info));
+                                        m_image_indices[frame_info.stream].push_back(sample_index);
                                         ++index;
                                         LOG_VERBOSE("frame sample indexed, sample time - " << sample_info.capture_time)
                                         break;
@@ -215,7 +216,7 @@ namespace rs
                     return 0;
                 }
 
-                uint32_t disk_read::read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, unsigned long num_bytes_to_read)
+                uint32_t disk_read::read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, const uint8_t * data, unsigned long num_bytes_to_read)
                 {
                     throw std::runtime_error("unsupported");
                 }
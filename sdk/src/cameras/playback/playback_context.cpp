@@ -4,6 +4,7 @@
 #include <memory>
 #include "rs/playback/playback_context.h"
 #include "playback_device_impl.h"
+#include "disk_read_factory.h"
 
 namespace rs
 {
@@ -16,6 +17,13 @@ namespace rs
             m_init_status = ((rs_device_ex*)m_devices[0])->init();
         }
 
+        context::context(const shared_recording & recording) : m_init_status(false)
+        {
+            m_devices = new rs_device*[1];
+            m_devices[0] = new rs_device_ex(recording.m_file_path, recording.m_recording);
+            m_init_status = ((rs_device_ex*)m_devices[0])->init();
+        }
+
         context::~context()
         {
             for(auto i = 0; i < 1; i++)
@@ -40,5 +48,27 @@ namespace rs
         {
             return m_init_status ? (device*)m_devices[0] : nullptr;
         }
+
+        frame_reader_interface * context::create_frame_reader()
+        {
+            return m_init_status ? ((rs_device_ex*)m_devices[0])->create_frame_reader() : nullptr;
+        }
+    
+        shared_recording::shared_recording(const char * file_path) : m_file_path(file_path)
+        {
+            std::unique_ptr<disk_read_interface> disk_read;
+            if(disk_read_factory::create_disk_read(file_path, disk_read) == core::status_no_error)
+                m_recording = std::move(disk_read);
+        }
+
+        shared_recording::~shared_recording()
+        {
+
+        }
+
+        bool shared_recording::is_open() const
+        {
+            return m_recording != nullptr;
+        }
     }
 }
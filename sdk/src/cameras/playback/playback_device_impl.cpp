@@ -8,6 +8,7 @@
 #include <type_traits>
 #include "playback_device_impl.h"
 #include "disk_read_factory.h"
+#include "frame_reader.h"
 #include "rs/playback/playback_device.h"
 
 using namespace rs::core;
@@ -88,11 +89,14 @@ namespace rs
             void release() override { }
         };
 
-        rs_device_ex::rs_device_ex(const std::string &file_path) :
+        rs_device_ex::rs_device_ex(const std::string &file_path, std::shared_ptr<disk_read_interface> recording) :
             m_file_path(file_path),
             m_is_streaming(false),
             m_wait_streams_request(false),
-            m_enabled_streams_count(0)
+            m_recording(recording),
+            m_enabled_streams_count(0),
+            m_callback_queue_depth(DEFAULT_CALLBACK_QUEUE_DEPTH),
+            m_callback_queue_policy(playback::callback_queue_policy::drop_oldest)
         {
 
         }
@@ -296,14 +300,11 @@ namespace rs
                     return;
                 }
                 m_wait_streams_request = true;
+                m_wait_streams_request_cv.notify_one();
             }
 
             std::unique_lock<std::mutex> guard(m_all_stream_available_mutex);
-            if(m_is_streaming)
-            {
-                m_all_stream_available_cv.wait(guard);
-                guard.unlock();
-            }
+            m_all_stream_available_cv.wait(guard, [this]() -> bool { return !m_wait_streams_request || !m_is_streaming; });
         }
 
         bool rs_device_ex::poll_all_streams()
@@ -469,6 +470,11 @@ namespace rs
         void rs_device_ex::internal_pause()
         {
             m_is_streaming = false;
+            {
+                //release the reader thread in case it waits for the next frames request
+                std::lock_guard<std::mutex> guard(m_mutex);
+                m_wait_streams_request_cv.notify_one();
+            }
             m_disk_read->pause();
             signal_all();
             join_callbacks_threads();
@@ -528,6 +534,105 @@ namespace rs
             m_disk_read->set_realtime(realtime);
         }
 
+        void rs_device_ex::set_reverse_playback(bool reverse)
+        {
+            m_disk_read->set_reverse(reverse);
+        }
+
+        bool rs_device_ex::is_reverse_playback()
+        {
+            return m_disk_read->query_reverse();
+        }
+
+        bool rs_device_ex::set_playback_range(uint64_t start_time, uint64_t end_time)
+        {
+            LOG_FUNC_SCOPE();
+            return m_disk_read->set_playback_range(start_time, end_time);
+        }
+
+        void rs_device_ex::set_loop_playback(bool loop)
+        {
+            m_disk_read->set_loop(loop);
+        }
+
+        bool rs_device_ex::is_loop_playback()
+        {
+            return m_disk_read->query_loop();
+        }
+
+        uint32_t rs_device_ex::get_loop_count()
+        {
+            return m_disk_read->query_loop_count();
+        }
+
+        bool rs_device_ex::set_playback_speed(double speed)
+        {
+            return m_disk_read->set_playback_speed(speed);
+        }
+
+        double rs_device_ex::get_playback_speed()
+        {
+            return m_disk_read->query_playback_speed();
+        }
+
+        double rs_device_ex::get_achieved_playback_speed()
+        {
+            return m_disk_read->query_achieved_playback_speed();
+        }
+
+        playback::timing_stats rs_device_ex::get_timing_stats()
+        {
+            return m_disk_read->query_timing_stats();
+        }
+
+        void rs_device_ex::set_frame_cache_size(uint64_t size)
+        {
+            m_disk_read->set_frame_cache_size(size);
+        }
+
+        uint64_t rs_device_ex::get_frame_cache_size()
+        {
+            return m_disk_read->query_frame_cache_size();
+        }
+
+        bool rs_device_ex::set_callback_queue_depth(uint32_t depth)
+        {
+            if(depth == 0 || depth > MAX_CALLBACK_QUEUE_DEPTH)
+                return false;
+            std::lock_guard<std::mutex> guard(m_pause_resume_mutex);
+            m_callback_queue_depth = depth;
+            return true;
+        }
+
+        uint32_t rs_device_ex::get_callback_queue_depth()
+        {
+            return m_callback_queue_depth;
+        }
+
+        void rs_device_ex::set_callback_queue_policy(playback::callback_queue_policy policy)
+        {
+            std::lock_guard<std::mutex> guard(m_pause_resume_mutex);
+            m_callback_queue_policy = policy;
+        }
+
+        playback::callback_queue_policy rs_device_ex::get_callback_queue_policy()
+        {
+            return m_callback_queue_policy;
+        }
+
+        uint32_t rs_device_ex::get_callback_queue_high_water_mark(rs_stream stream)
+        {
+            auto it = m_frame_thread.find(stream);
+            if(it == m_frame_thread.end())
+                return 0;
+            return it->second.samples.high_water_mark();
+        }
+
+        uint32_t rs_device_ex::get_motion_callback_queue_high_water_mark()
+        {
+            return m_imu_thread.samples.high_water_mark();
+        }
+
         int rs_device_ex::get_frame_index(rs_stream stream)
         {
             auto frame = m_available_streams[stream]->get_frame();
@@ -563,6 +668,11 @@ namespace rs
             return m_disk_read->query_file_info();
         }
 
+        frame_reader_interface * rs_device_ex::create_frame_reader()
+        {
+            return new frame_reader(m_disk_read.get());
+        }
+
         void rs_device_ex::handle_frame_callback(std::shared_ptr<file_types::sample> sample)
         {
             if(!sample)
@@ -580,12 +690,19 @@ namespace rs
                 if(m_frame_thread.find(stream) == m_frame_thread.end()) return;
                 if(m_disk_read->query_realtime())
                 {
-                    std::unique_lock<std::mutex> guard(m_frame_thread[stream].mutex);
-                    if(m_frame_thread[stream].sample != nullptr)
+                    auto & sync = m_frame_thread[stream];
+                    if(sync.queue_policy == playback::callback_queue_policy::drop_oldest)
+                    {
+                        //the callback thread fell behind by more than the queue depth, it skips the oldest queued frames
+                        auto dropped_count = sync.samples.push_overwrite(frame);
+                        sync.notify_consumer();
+                        if(dropped_count > 0)
+                            m_disk_read->update_frame_drop_count(stream, dropped_count);
+                    }
+                    else if(sync.samples.push(frame))
+                        sync.notify_consumer();
+                    else//the callback thread fell behind by more than the queue depth
                         m_disk_read->update_frame_drop_count(stream, 1);
-                    m_frame_thread[stream].sample = frame;
-                    guard.unlock();
-                    m_frame_thread[stream].sample_ready_cv.notify_one();
                 }
                 else//asynced reader non realtime mode
                 {
@@ -595,15 +712,14 @@ namespace rs
             }
             else
             {
+                std::unique_lock<std::mutex> guard(m_mutex);
                 if(!m_disk_read->query_realtime())//synced reader non realtime mode
                 {
-                    while(!m_wait_streams_request && m_is_streaming)
-                        std::this_thread::sleep_for (std::chrono::milliseconds(5));//TODO:[mk] replace with cv
+                    //hold the reader until the application requests the next frames
+                    m_wait_streams_request_cv.wait(guard, [this]() -> bool { return m_wait_streams_request || !m_is_streaming; });
                 }
                 if(m_wait_streams_request)
                 {
-                    std::lock_guard<std::mutex> guard(m_mutex);
-
                     if(all_streams_available())
                     {
                         for(auto it = m_curr_frames.begin(); it != m_curr_frames.end(); ++it)
@@ -628,24 +744,22 @@ namespace rs
 
         void rs_device_ex::frame_callback_thread(rs_stream stream)
         {
-            auto pred = [this, stream]()->bool{ return (m_frame_thread[stream].sample != nullptr) || (m_is_streaming == false);};
+            auto & sync = m_frame_thread[stream];
+            auto pred = [this, &sync]()->bool{ return (sync.samples.empty() == false) || (m_is_streaming == false);};
 
             while(m_is_streaming)
             {
-                std::unique_lock<std::mutex> guard(m_frame_thread[stream].mutex);
-                m_frame_thread[stream].sample_ready_cv.wait(guard, pred);
-                rs_frame_ref_impl * frame_ref = nullptr;
-                if(m_is_streaming)
+                std::shared_ptr<file_types::frame_sample> frame;
+                if(!sync.samples.pop(frame))
                 {
-                    frame_ref = new rs_frame_ref_impl(m_frame_thread[stream].sample);
-                    m_frame_thread[stream].active_samples_count++;
-                    m_frame_thread[stream].sample = nullptr;
+                    sync.wait_for_sample(pred);
+                    continue;
                 }
-                guard.unlock();
-                if(frame_ref)
                 {
-                    m_frame_thread[stream].callback->on_frame(this, frame_ref);
+                    std::lock_guard<std::mutex> guard(sync.mutex);
+                    sync.active_samples_count++;
                 }
+                sync.callback->on_frame(this, new rs_frame_ref_impl(frame));
             }
         }
 
@@ -653,15 +767,10 @@ namespace rs
         {
             if(m_disk_read->query_realtime())
             {
-                std::unique_lock<std::mutex> guard(m_imu_thread.mutex);
-                if(m_imu_thread.samples.size() >= m_imu_thread.max_queue_size)
-                {
-                    m_imu_thread.samples.pop();
+                if(m_imu_thread.samples.push(sample))
+                    m_imu_thread.notify_consumer();
+                else
                     m_disk_read->update_imu_drop_count(1);
-                }
-                m_imu_thread.samples.push(sample);
-                guard.unlock();
-                m_imu_thread.sample_ready_cv.notify_one();
             }
             else
             {
@@ -675,22 +784,21 @@ namespace rs
 
             while(m_is_streaming || !m_imu_thread.samples.empty())
             {
-                std::unique_lock<std::mutex> guard(m_imu_thread.mutex);
-                m_imu_thread.sample_ready_cv.wait(guard, pred);
-                std::queue<std::shared_ptr<core::file_types::sample>> data;
-                std::swap(m_imu_thread.samples, data);
-                guard.unlock();
-                while (!data.empty())
+                std::shared_ptr<file_types::sample> sample;
+                if(!m_imu_thread.samples.pop(sample))
                 {
-                    m_imu_thread.push_sample_to_user(data.front());
-                    data.pop();
+                    m_imu_thread.wait_for_sample(pred);
+                    continue;
                 }
+                m_imu_thread.push_sample_to_user(sample);
             }
         }
 
         bool rs_device_ex::init()
         {
-            if(disk_read_factory::create_disk_read(m_file_path.c_str(), m_disk_read) != status::status_no_error)
+            auto sts = m_recording ? disk_read_factory::create_disk_read_view(m_recording, m_disk_read) :
+                                     disk_read_factory::create_disk_read(m_file_path.c_str(), m_disk_read);
+            if(sts != status::status_no_error)
             {
                 return false;
             }
@@ -790,12 +898,15 @@ namespace rs
             for(auto it = m_frame_thread.begin(); it != m_frame_thread.end(); ++it)
             {
                 it->second.active_samples_count = 0;
+                //frames which were queued before the last stop are not delivered
+                it->second.samples.reset(m_callback_queue_depth);
+                it->second.queue_policy = m_callback_queue_policy;
                 it->second.thread = std::thread(&rs_device_ex::frame_callback_thread, this, it->first);
             }
             if(m_disk_read->is_motion_tracking_enabled())
             {
+                m_imu_thread.samples.reset(LIBREALSENSE_IMU_BUFFER_SIZE); // librealsense motion buffer size, there is no requirment for the buffers size to match.
                 m_imu_thread.thread = std::thread(&rs_device_ex::motion_callback_thread, this);
-                m_imu_thread.max_queue_size = LIBREALSENSE_IMU_BUFFER_SIZE; // librealsense motion buffer size, there is no requirment for the buffers size to match.
             }
         }
 
@@ -862,6 +973,96 @@ namespace rs
             ((rs_device_ex*)this)->set_real_time(realtime);
         }
 
+        void device::set_reverse_playback(bool reverse)
+        {
+            ((rs_device_ex*)this)->set_reverse_playback(reverse);
+        }
+
+        bool device::is_reverse_playback()
+        {
+            return ((rs_device_ex*)this)->is_reverse_playback();
+        }
+
+        bool device::set_playback_range(uint64_t start_time, uint64_t end_time)
+        {
+            return ((rs_device_ex*)this)->set_playback_range(start_time, end_time);
+        }
+
+        void device::set_loop_playback(bool loop)
+        {
+            ((rs_device_ex*)this)->set_loop_playback(loop);
+        }
+
+        bool device::is_loop_playback()
+        {
+            return ((rs_device_ex*)this)->is_loop_playback();
+        }
+
+        uint32_t device::get_loop_count()
+        {
+            return ((rs_device_ex*)this)->get_loop_count();
+        }
+
+        bool device::set_playback_speed(double speed)
+        {
+            return ((rs_device_ex*)this)->set_playback_speed(speed);
+        }
+
+        double device::get_playback_speed()
+        {
+            return ((rs_device_ex*)this)->get_playback_speed();
+        }
+
+        double device::get_achieved_playback_speed()
+        {
+            return ((rs_device_ex*)this)->get_achieved_playback_speed();
+        }
+
+        timing_stats device::get_timing_stats()
+        {
+            return ((rs_device_ex*)this)->get_timing_stats();
+        }
+
+        void device::set_frame_cache_size(uint64_t size)
+        {
+            ((rs_device_ex*)this)->set_frame_cache_size(size);
+        }
+
+        uint64_t device::get_frame_cache_size()
+        {
+            return ((rs_device_ex*)this)->get_frame_cache_size();
+        }
+
+        bool device::set_callback_queue_depth(uint32_t depth)
+        {
+            return ((rs_device_ex*)this)->set_callback_queue_depth(depth);
+        }
+
+        uint32_t device::get_callback_queue_depth()
+        {
+            return ((rs_device_ex*)this)->get_callback_queue_depth();
+        }
+
+        void device::set_callback_queue_policy(callback_queue_policy policy)
+        {
+            ((rs_device_ex*)this)->set_callback_queue_policy(policy);
+        }
+
+        callback_queue_policy device::get_callback_queue_policy()
+        {
+            return ((rs_device_ex*)this)->get_callback_queue_policy();
+        }
+
+        uint32_t device::get_callback_queue_high_water_mark(rs::stream stream)
+        {
+            return ((rs_device_ex*)this)->get_callback_queue_high_water_mark((rs_stream)stream);
+        }
+
+        uint32_t device::get_motion_callback_queue_high_water_mark()
+        {
+            return ((rs_device_ex*)this)->get_motion_callback_queue_high_water_mark();
+        }
+
         int device::get_frame_index(rs::stream stream)
         {
             return ((rs_device_ex*)this)->get_frame_index((rs_stream)stream);
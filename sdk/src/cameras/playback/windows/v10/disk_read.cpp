@@ -44,6 +44,7 @@ namespace rs
                 {
                     LOG_FUNC_SCOPE();
                     pause();
+                    stop_indexing();
                 }
 
                 void disk_read::handle_ds_projection(std::vector<uint8_t> &projection_data)
@@ -184,8 +185,6 @@ namespace rs
                 {
                     if (m_is_index_complete) return;
 
-                    std::lock_guard<std::mutex> guard(m_mutex);
-
                     for (uint32_t index = 0; index < number_of_samples;)
                     {
                         disk_format::chunk chunk = {};
@@ -223,8 +222,10 @@ namespace rs
                                 sample_info.capture_time = static_cast<uint64_t>(frame_info.time_stamp);
                                 m_file_indexing->get_position(&sample_info.offset);
                                 frame_info.index_in_stream = static_cast<uint32_t>(m_image_indices[frame_info.stream].size());
-                                m_image_indices[frame_info.stream].push_back(static_cast<uint32_t>(m_samples_desc.size()));
+                                //the descriptor is published before the stream index which points to it, the readers use the stream indices without locking
+                                auto sample_index = static_cast<uint32_t>(m_samples_desc.size());
                                 m_samples_desc.push_back(std::make_shared<core::file_types::frame_sample>(frame_info, sample_info));
+                                m_image_indices[frame_info.stream].push_back(sample_index);
                                 ++index;
                                 LOG_VERBOSE("frame sample indexed, sample time - " << sample_info.capture_time)
                             }
@@ -240,10 +241,9 @@ namespace rs
                     }
                 }
 
-                uint32_t disk_read::read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, unsigned long num_bytes_to_read)
+                uint32_t disk_read::read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample> & frame, const uint8_t * data, unsigned long num_bytes_to_read)
                 {
                     //Does not do anything at the moment
-                    m_file_data_read->set_position(num_bytes_to_read, core::move_method::current);
                     return 0;
                 }
             }
@@ -113,6 +113,23 @@ namespace rs
             }
         }
 
+        void disk_write::write_encoded_sample(std::shared_ptr<file_types::sample> &sample, const uint8_t * data, uint32_t data_size)
+        {
+            //the file is released by stop, direct writes are allowed only between configure and start or stop
+            if(!m_is_configured || !m_file || m_thread.joinable())
+                throw std::runtime_error("samples can be written directly only to a configured open file which isn't recording");
+            write_sample_info(sample);
+            if(sample->info.type == file_types::sample_type::st_image)
+            {
+                auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+                write_frame(frame, data, data_size);
+            }
+            else
+            {
+                write_sample(sample);
+            }
+        }
+
         bool disk_write::start()
         {
             LOG_FUNC_SCOPE();
@@ -140,7 +157,18 @@ namespace rs
 
             guard.lock();
             if(m_file)
+            {
+                try
+                {
+                    write_streams_num_of_frames();
+                }
+                catch(const std::exception & e)
+                {
+                    LOG_ERROR("failed to write the streams number of frames - " << e.what());
+                }
                 m_file->close();
+                m_file.reset();
+            }
             guard.unlock();
         }
 
@@ -421,6 +449,14 @@ namespace rs
             LOG_VERBOSE("stream - " << stream << " ,number of frames - " << frame_count)
         }
 
+        void disk_write::write_streams_num_of_frames()
+        {
+            //the final frames count of each stream is written once, when the file is closed, so the reader doesn't have to count the frames.
+            //streams without frames keep the 0 count, which the reader treats as unknown.
+            for(auto it = m_number_of_frames.begin(); it != m_number_of_frames.end(); ++it)
+                write_stream_num_of_frames(it->first, it->second);
+        }
+
         void disk_write::write_sample_info(std::shared_ptr<file_types::sample> &sample)
         {
             file_types::chunk_info chunk = {};
@@ -444,10 +480,6 @@ namespace rs
             {
                 case file_types::sample_type::st_image:
                 {
-                    file_types::chunk_info chunk = {};
-                    chunk.id = file_types::chunk_id::chunk_frame_info;
-                    file_types::disk_format::frame_info frame_info = {};
-                    chunk.size = sizeof(frame_info);
                     auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
                     if (frame)
                     {
@@ -467,16 +499,10 @@ namespace rs
                             data_size = frame->finfo.stride * frame->finfo.height;
                         }
 
-                        frame_info.data = frame->finfo;
-
-                        uint32_t bytes_written = 0;
-                        write_to_file(&chunk, sizeof(chunk), bytes_written);
-                        write_to_file(&frame_info, chunk.size, bytes_written);
-                        write_frame_metadata_chunk(frame->metadata);
                         auto data = frame->finfo.ctype == file_types::compression_type::none ? frame->data : m_encoded_data.data();
-                        write_image_data(frame->finfo, data, data_size);
-                        LOG_VERBOSE("write frame, " "stream type - " << frame->finfo.stream << " capture time - " << frame->info.capture_time
-                                    << " time stamp - " << frame->finfo.time_stamp << " frame number - " << frame->finfo.number);
+                        write_frame(frame, data, data_size);
+                        std::lock_guard<std::mutex> guard(m_main_mutex);
+                        m_samples_count[frame->finfo.stream]--;
                     }
                 }
                 break;
@@ -549,6 +575,23 @@ namespace rs
             }
         }
 
+        void disk_write::write_frame(std::shared_ptr<file_types::frame_sample> &frame, const uint8_t * data, uint32_t data_size)
+        {
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_frame_info;
+            file_types::disk_format::frame_info frame_info = {};
+            chunk.size = sizeof(frame_info);
+            frame_info.data = frame->finfo;
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(&frame_info, chunk.size, bytes_written);
+            write_frame_metadata_chunk(frame->metadata);
+            write_image_data(frame->finfo, data, data_size);
+            LOG_VERBOSE("write frame, " "stream type - " << frame->finfo.stream << " capture time - " << frame->info.capture_time
+                        << " time stamp - " << frame->finfo.time_stamp << " frame number - " << frame->finfo.number);
+        }
+
         void disk_write::write_frame_metadata_chunk(const std::map<rs_frame_metadata, double>& metadata)
         {
             using metadata_pair_type = typename std::remove_reference<decltype(metadata)>::type::value_type; //get the undrlying pair of the map same as in playback
@@ -587,9 +630,6 @@ namespace rs
             m_file->write_bytes(data, chunk.size, bytes_written);
 
             m_number_of_frames[frame_info.stream]++;
-            write_stream_num_of_frames(frame_info.stream, m_number_of_frames[frame_info.stream]);
-            std::lock_guard<std::mutex> guard(m_main_mutex);
-            m_samples_count[frame_info.stream]--;
         }
     }
 }
@@ -46,6 +46,9 @@ namespace rs
             bool is_configured() {return m_is_configured;}
             core::status configure(const configuration &config);
             void record_sample(std::shared_ptr<core::file_types::sample> &sample);
+            //writes the sample on the calling thread, bypassing the samples queue and the samples drop policy, can't be used after start or stop.
+            //the image data of frame samples is written as is, and should be encoded according to the frame compression type.
+            void write_encoded_sample(std::shared_ptr<core::file_types::sample> &sample, const uint8_t * data, uint32_t data_size);
 
         private:
             void write_thread();
@@ -60,9 +63,11 @@ namespace rs
             void write_properties(const std::vector<core::file_types::device_cap> &properties);
             void write_first_frame_offset();
             void write_stream_num_of_frames(rs_stream stream, int32_t frame_count);
+            void write_streams_num_of_frames();
             //sample type is written separatly since we need to know how to read the sample info
             void write_sample_info(std::shared_ptr<rs::core::file_types::sample> &sample);
             void write_sample(std::shared_ptr<rs::core::file_types::sample> &sample);
+            void write_frame(std::shared_ptr<rs::core::file_types::frame_sample> &frame, const uint8_t * data, uint32_t data_size);
             void write_frame_metadata_chunk(const std::map<rs_frame_metadata, double>& metadata);
             void write_image_data(const rs::core::file_types::frame_info &frame_info, const uint8_t * data, uint32_t data_size);
             void write_to_file(const void* data, unsigned int number_of_bytes_to_write, unsigned int& numberOfBytesWritten);
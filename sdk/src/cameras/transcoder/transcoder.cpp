@@ -0,0 +1,279 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+#include "rs/record/transcoder.h"
+#include "disk_write.h"
+#include "disk_read_factory.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace record
+    {
+        namespace
+        {
+            //maximal number of samples per worker thread which are transcoded ahead of the written sample
+            const uint32_t REORDER_WINDOW_PER_THREAD = 4;
+
+            struct transcoded_sample
+            {
+                std::shared_ptr<file_types::sample> sample;
+                std::vector<uint8_t>                encoded_data; //empty if the frame is written uncompressed
+            };
+
+            //the sample offset is updated when the sample is written, the source descriptors are copied to keep the source index intact
+            std::shared_ptr<file_types::sample> copy_sample(const std::shared_ptr<file_types::sample> & sample)
+            {
+                switch(sample->info.type)
+                {
+                    case file_types::sample_type::st_motion:
+                    {
+                        auto motion = std::static_pointer_cast<file_types::motion_sample>(sample);
+                        return std::make_shared<file_types::motion_sample>(motion->data, motion->info);
+                    }
+                    case file_types::sample_type::st_time:
+                    {
+                        auto time_stamp = std::static_pointer_cast<file_types::time_stamp_sample>(sample);
+                        return std::make_shared<file_types::time_stamp_sample>(time_stamp->data, time_stamp->info);
+                    }
+                    case file_types::sample_type::st_debug_event:
+                    {
+                        auto debug_event = std::static_pointer_cast<file_types::debug_event_sample>(sample);
+                        return std::make_shared<file_types::debug_event_sample>(debug_event->event_type, debug_event->info, debug_event->debug_data);
+                    }
+                    default: return nullptr;
+                }
+            }
+
+            bool transcode_sample(playback::disk_read_interface & reader, playback::image_read_context & context, compression::encoder & encoder,
+                                  uint32_t index, transcoded_sample & transcoded)
+            {
+                auto sample = reader.read_sample(index, context);
+                if(!sample) return false;
+                if(sample->info.type != file_types::sample_type::st_image)
+                {
+                    transcoded.sample = copy_sample(sample);
+                    return transcoded.sample != nullptr;
+                }
+
+                //the frame is decoded to a new sample which is owned by this worker
+                auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+                if(!frame->data) return false;
+                frame->finfo.ctype = encoder.get_compression_type(frame->finfo.stream);
+                if(frame->finfo.ctype != file_types::compression_type::none)
+                {
+                    uint32_t encoded_size = 0;
+                    transcoded.encoded_data.resize(frame->finfo.stride * frame->finfo.height);
+                    if(encoder.encode_frame(frame->finfo, frame->data, transcoded.encoded_data.data(), encoded_size) == status_no_error)
+                    {
+                        transcoded.encoded_data.resize(encoded_size);
+                    }
+                    else
+                    {
+                        //same as the recorder, frames which don't compress are written uncompressed
+                        frame->finfo.ctype = file_types::compression_type::none;
+                        transcoded.encoded_data.clear();
+                    }
+                }
+                transcoded.sample = frame;
+                return true;
+            }
+        }
+
+        transcoder::transcoder(const char * source_file_path, const char * target_file_path) :
+            m_source_file_path(source_file_path),
+            m_target_file_path(target_file_path),
+            m_threads_count(0),
+            m_transcoded_samples_count(0)
+        {
+
+        }
+
+        void transcoder::set_compression(rs::stream stream, compression_level compression_level)
+        {
+            m_compression_config[stream] = compression_level;
+        }
+
+        void transcoder::set_threads_count(uint32_t threads_count)
+        {
+            m_threads_count = threads_count;
+        }
+
+        status transcoder::run()
+        {
+            LOG_FUNC_SCOPE();
+            m_transcoded_samples_count = 0;
+
+            std::unique_ptr<playback::disk_read_interface> reader;
+            if(playback::disk_read_factory::create_disk_read(m_source_file_path.c_str(), reader) != status_no_error)
+            {
+                LOG_ERROR("failed to open the source file - " << m_source_file_path.c_str());
+                return status_file_open_failed;
+            }
+
+            configuration config = {};
+            config.m_file_path = m_target_file_path;
+            for(auto & info : reader->get_camera_info())
+                config.m_camera_info[info.first] = std::make_pair(static_cast<uint32_t>(info.second.size() + 1), info.second.c_str());
+            for(auto & property : reader->get_properties())
+                config.m_options.push_back({property.first, property.second});
+            for(auto & stream_info : reader->get_streams_infos())
+            {
+                config.m_stream_profiles[stream_info.first] = stream_info.second.profile;
+                auto compression = m_compression_config.find(static_cast<rs::stream>(stream_info.first));
+                config.m_compression_config[stream_info.first] = compression != m_compression_config.end() ? compression->second : compression_level::high;
+            }
+            config.m_coordinate_system = static_cast<file_types::coordinate_system>(reader->query_coordinate_system());
+            config.m_capabilities = reader->get_capabilities();
+            config.m_motion_intrinsics = reader->get_motion_intrinsics();
+            config.m_capture_mode = reader->query_capture_mode();
+
+            disk_write writer;
+            status configure_status = status_no_error;
+            try
+            {
+                configure_status = writer.configure(config);
+            }
+            catch(const std::exception & e)
+            {
+                LOG_ERROR("failed to create the target file - " << m_target_file_path.c_str() << ", " << e.what());
+                return status_file_write_failed;
+            }
+            if(configure_status != status_no_error)
+            {
+                LOG_ERROR("failed to configure the target file - " << m_target_file_path.c_str() << ", status - " << static_cast<int>(configure_status));
+                return status_file_write_failed;
+            }
+
+            auto samples_count = reader->query_number_of_samples();
+            auto threads_count = m_threads_count > 0 ? m_threads_count : std::max(1u, std::thread::hardware_concurrency());
+            auto window_size = threads_count * REORDER_WINDOW_PER_THREAD;
+
+            //the workers read, decode and encode the samples out of order, the calling thread writes them in the source order.
+            //a worker doesn't start a sample which is more than window_size samples ahead of the next written sample,
+            //to limit the memory held by the transcoded samples.
+            std::mutex mutex;
+            std::condition_variable transcoded_cv;
+            std::condition_variable written_cv;
+            std::map<uint32_t, transcoded_sample> transcoded_samples;
+            std::atomic<uint32_t> next_index(0);
+            uint32_t written_count = 0;
+            bool failed = false;
+
+            auto worker = [&]()
+            {
+                auto context = reader->create_image_read_context();
+                compression::encoder encoder;
+                for(auto & profile : config.m_stream_profiles)
+                {
+                    auto compression = config.m_compression_config.at(profile.first);
+                    if(compression != compression_level::disabled)
+                        encoder.add_codec(profile.first, profile.second.info.format, compression);
+                }
+
+                while(true)
+                {
+                    auto index = next_index++;
+                    if(index >= samples_count)
+                        break;
+                    {
+                        std::unique_lock<std::mutex> guard(mutex);
+                        written_cv.wait(guard, [&]() { return failed || index < written_count + window_size; });
+                        if(failed)
+                            break;
+                    }
+
+                    transcoded_sample transcoded;
+                    bool succeeded = false;
+                    try
+                    {
+                        succeeded = context && transcode_sample(*reader, *context, encoder, index, transcoded);
+                    }
+                    catch(const std::exception & e)
+                    {
+                        LOG_ERROR("failed to transcode sample " << index << ", " << e.what());
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> guard(mutex);
+                        if(succeeded)
+                            transcoded_samples[index] = std::move(transcoded);
+                        else
+                            failed = true;
+                    }
+                    transcoded_cv.notify_all();
+                    if(!succeeded)
+                        written_cv.notify_all();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for(uint32_t i = 0; i < threads_count; i++)
+                workers.push_back(std::thread(worker));
+
+            status sts = status_no_error;
+            for(uint32_t index = 0; index < samples_count; index++)
+            {
+                transcoded_sample transcoded;
+                {
+                    std::unique_lock<std::mutex> guard(mutex);
+                    transcoded_cv.wait(guard, [&]() { return failed || transcoded_samples.find(index) != transcoded_samples.end(); });
+                    auto it = transcoded_samples.find(index);
+                    if(it == transcoded_samples.end())
+                    {
+                        sts = status_file_read_failed;
+                        break;
+                    }
+                    transcoded = std::move(it->second);
+                    transcoded_samples.erase(it);
+                }
+
+                try
+                {
+                    const uint8_t * data = nullptr;
+                    uint32_t data_size = 0;
+                    if(transcoded.sample->info.type == file_types::sample_type::st_image)
+                    {
+                        auto frame = std::static_pointer_cast<file_types::frame_sample>(transcoded.sample);
+                        data = transcoded.encoded_data.empty() ? frame->data : transcoded.encoded_data.data();
+                        data_size = transcoded.encoded_data.empty() ? frame->finfo.stride * frame->finfo.height : static_cast<uint32_t>(transcoded.encoded_data.size());
+                    }
+                    writer.write_encoded_sample(transcoded.sample, data, data_size);
+                }
+                catch(const std::exception & e)
+                {
+                    LOG_ERROR("failed to write sample " << index << ", " << e.what());
+                    sts = status_file_write_failed;
+                    break;
+                }
+                m_transcoded_samples_count++;
+
+                {
+                    std::lock_guard<std::mutex> guard(mutex);
+                    written_count = index + 1;
+                }
+                written_cv.notify_all();
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                failed |= sts != status_no_error;
+            }
+            written_cv.notify_all();
+            for(auto & thread : workers)
+                thread.join();
+
+            writer.stop();
+            return sts;
+        }
+    }
+}
@@ -1,6 +1,7 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <cmath>
 #include <cstring>
 #include <utility>
 
@@ -19,7 +20,7 @@ namespace rs
                                             pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold);
 
 
-        math_projection::math_projection() {}
+        math_projection::math_projection() : m_projection_row_kernel(select_projection_row_kernel()) {}
 
         //Added
         status REFCALL math_projection::rs_projection_init_32f(sizeI32 roi_size, float camera_src[4], float inv_distortion[5], projection_spec_32f *pspec)
@@ -90,8 +91,218 @@ namespace rs
             return status::status_no_error;
         }
 
-        //Added
+        //transformation stages of the points array projection, each combination has its own specialized projection
+        enum array_projection_stage
+        {
+            stage_camera_src     = 1,
+            stage_inv_distortion = 2,
+            stage_rotation       = 4,
+            stage_translation    = 8,
+            stage_distortion_dst = 16,
+            stage_camera_dst     = 32,
+            stages_count         = 64
+        };
+
+        struct array_projection_coeffs
+        {
+            float inv_focal[2];
+            float principal[2];
+            float inv_distortion[5];
+            float rotation[9];
+            float translation[3];
+            float distortion_dst[5];
+            float camera_dst[4];
+        };
+
+        //float only projection with the stages resolved at compile time, the point coordinates are read and written with constant strides
+        //and don't alias, so the loop is vectorized by the compiler.
+        //the results match the reference projection up to the float rounding of the distortion.
+        template<int stages, bool is_soa>
+        static void array_projection_32f(const float * __restrict src_x, const float * __restrict src_y, const float * __restrict src_z,
+                                         float * __restrict dst_x, float * __restrict dst_y, float * __restrict dst_z,
+                                         int length, const array_projection_coeffs &coeffs)
+        {
+            //local copy, so the compiler knows the coefficients aren't changed by the destination writes
+            const array_projection_coeffs k = coeffs;
+            const int src_stride = is_soa ? 1 : 3;
+            const int dst_stride = is_soa ? 1 : ((stages & stage_camera_dst) ? 2 : 3);
+            for (int n = 0; n < length; n++)
+            {
+                float x = src_x[n * src_stride];
+                float y = src_y[n * src_stride];
+                float z = src_z[n * src_stride];
+                if (stages & stage_camera_src)
+                {
+                    x = (x - k.principal[0]) * k.inv_focal[0];
+                    y = (y - k.principal[1]) * k.inv_focal[1];
+                    if (stages & stage_inv_distortion)
+                    {
+                        //same as the reference projection, the normalized coordinates are normalized again before the distortion
+                        float u = (x - k.principal[0]) * k.inv_focal[0];
+                        float v = (y - k.principal[1]) * k.inv_focal[1];
+                        float r2 = u * u + v * v;
+                        float radial = 1.f + r2 * (k.inv_distortion[0] + r2 * (k.inv_distortion[1] + r2 * k.inv_distortion[4]));
+                        float uv2 = 2.f * u * v;
+                        x = u * radial + k.inv_distortion[2] * uv2 + k.inv_distortion[3] * (r2 + 2.f * u * u);
+                        y = v * radial + k.inv_distortion[3] * uv2 + k.inv_distortion[2] * (r2 + 2.f * v * v);
+                    }
+                    x *= z;
+                    y *= z;
+                }
+                if (stages & stage_rotation)
+                {
+                    float tmp0 = k.rotation[0] * x + k.rotation[1] * y + k.rotation[2] * z;
+                    float tmp1 = k.rotation[3] * x + k.rotation[4] * y + k.rotation[5] * z;
+                    z          = k.rotation[6] * x + k.rotation[7] * y + k.rotation[8] * z;
+                    x = tmp0;
+                    y = tmp1;
+                }
+                if (stages & stage_translation)
+                {
+                    x += k.translation[0];
+                    y += k.translation[1];
+                    z += k.translation[2];
+                }
+                if (stages & stage_camera_dst)
+                {
+                    //points on the camera plane are projected to 0, selected without a branch
+                    bool is_valid = std::fabs(z) > MINABS_32F;
+                    float inv_z = 1.f / z;
+                    float u = x * inv_z;
+                    float v = y * inv_z;
+                    if (stages & stage_distortion_dst)
+                    {
+                        float r2 = u * u + v * v;
+                        float radial = 1.f + r2 * (k.distortion_dst[0] + r2 * (k.distortion_dst[1] + r2 * k.distortion_dst[4]));
+                        float uv2 = 2.f * u * v;
+                        float du = k.distortion_dst[2] * uv2 + k.distortion_dst[3] * (r2 + 2.f * u * u);
+                        float dv = k.distortion_dst[3] * uv2 + k.distortion_dst[2] * (r2 + 2.f * v * v);
+                        u = u * radial + du;
+                        v = v * radial + dv;
+                    }
+                    dst_x[n * dst_stride] = is_valid ? u * k.camera_dst[0] + k.camera_dst[1] : 0.f;
+                    dst_y[n * dst_stride] = is_valid ? v * k.camera_dst[2] + k.camera_dst[3] : 0.f;
+                }
+                else
+                {
+                    dst_x[n * dst_stride] = x;
+                    dst_y[n * dst_stride] = y;
+                    dst_z[n * dst_stride] = z;
+                }
+            }
+        }
+
+        typedef void (*array_projection_32f_fn)(const float*, const float*, const float*, float*, float*, float*, int, const array_projection_coeffs&);
+
+        //fills the projections table of all the stages combinations
+        template<int stages, bool is_soa>
+        struct array_projection_table
+        {
+            static void fill(array_projection_32f_fn *table)
+            {
+                table[stages] = &array_projection_32f<stages, is_soa>;
+                array_projection_table<stages - 1, is_soa>::fill(table);
+            }
+        };
+
+        template<bool is_soa>
+        struct array_projection_table<-1, is_soa>
+        {
+            static void fill(array_projection_32f_fn *) {}
+        };
+
+        static array_projection_32f_fn select_array_projection(bool is_soa, int stages)
+        {
+            static const struct tables
+            {
+                array_projection_32f_fn aos[stages_count];
+                array_projection_32f_fn soa[stages_count];
+                tables()
+                {
+                    array_projection_table<stages_count - 1, false>::fill(aos);
+                    array_projection_table<stages_count - 1, true>::fill(soa);
+                }
+            } projection_tables;
+            return is_soa ? projection_tables.soa[stages] : projection_tables.aos[stages];
+        }
+
+        static int prepare_array_projection(float camera_src[4], float inv_distortion_src[5], float rotation[9], float translation[3],
+                                            float distortion_dst[5], float camera_dst[4], array_projection_coeffs &k)
+        {
+            int stages = 0;
+            memset(&k, 0, sizeof(k));
+            if (camera_src)
+            {
+                stages |= stage_camera_src;
+                k.inv_focal[0] = 1.f / camera_src[0];
+                k.inv_focal[1] = 1.f / camera_src[2];
+                k.principal[0] = camera_src[1];
+                k.principal[1] = camera_src[3];
+                if (inv_distortion_src)
+                {
+                    stages |= stage_inv_distortion;
+                    memcpy(k.inv_distortion, inv_distortion_src, sizeof(k.inv_distortion));
+                }
+            }
+            if (rotation)
+            {
+                stages |= stage_rotation;
+                memcpy(k.rotation, rotation, sizeof(k.rotation));
+            }
+            if (translation)
+            {
+                stages |= stage_translation;
+                memcpy(k.translation, translation, sizeof(k.translation));
+            }
+            if (camera_dst)
+            {
+                stages |= stage_camera_dst;
+                memcpy(k.camera_dst, camera_dst, sizeof(k.camera_dst));
+                if (distortion_dst)
+                {
+                    stages |= stage_distortion_dst;
+                    memcpy(k.distortion_dst, distortion_dst, sizeof(k.distortion_dst));
+                    //same as the reference projection, the tangential distortion is applied only if the first coefficient is set
+                    if (distortion_dst[2] == 0) k.distortion_dst[3] = 0.f;
+                }
+            }
+            return stages;
+        }
+
         status REFCALL math_projection::rs_3d_array_projection_32f(const float *psrc, float *pdst, int length, float camera_src[4],
+                float inv_distortion_src[5], float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4])
+        {
+            if (psrc == 0 || pdst == 0) return status::status_handle_invalid;
+            if (length <= 0) return status::status_data_not_initialized;
+
+            //in place projection is handled by the reference projection, the specialized projection expects separate arrays
+            const float *src_end = psrc + 3 * length;
+            const float *dst_end = pdst + (camera_dst ? 2 : 3) * length;
+            if (psrc < dst_end && pdst < src_end)
+                return rs_3d_array_projection_32f_ref(psrc, pdst, length, camera_src, inv_distortion_src, rotation, translation, distortion_dst, camera_dst);
+
+            array_projection_coeffs coeffs;
+            int stages = prepare_array_projection(camera_src, inv_distortion_src, rotation, translation, distortion_dst, camera_dst, coeffs);
+            select_array_projection(false, stages)(psrc, psrc + 1, psrc + 2, pdst, pdst + 1, camera_dst ? nullptr : pdst + 2, length, coeffs);
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_3d_array_projection_soa_32f(const float *psrc_x, const float *psrc_y, const float *psrc_z,
+                float *pdst_x, float *pdst_y, float *pdst_z, int length, float camera_src[4],
+                float inv_distortion_src[5], float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4])
+        {
+            if (psrc_x == 0 || psrc_y == 0 || psrc_z == 0 || pdst_x == 0 || pdst_y == 0) return status::status_handle_invalid;
+            if (camera_dst == 0 && pdst_z == 0) return status::status_handle_invalid;
+            if (length <= 0) return status::status_data_not_initialized;
+
+            array_projection_coeffs coeffs;
+            int stages = prepare_array_projection(camera_src, inv_distortion_src, rotation, translation, distortion_dst, camera_dst, coeffs);
+            select_array_projection(true, stages)(psrc_x, psrc_y, psrc_z, pdst_x, pdst_y, pdst_z, length, coeffs);
+            return status::status_no_error;
+        }
+
+        //Added
+        status REFCALL math_projection::rs_3d_array_projection_32f_ref(const float *psrc, float *pdst, int length, float camera_src[4],
                 float inv_distortionSrc[5], float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4])
         {
 
@@ -205,106 +416,181 @@ namespace rs
             return sts;
         }
 
+        //scalar projection of a single depth pixel, returns false if the transformed depth is zero
+        static inline bool projection_16u32f_pixel(unsigned short depth, const pointF32 *uv, float *dst, float rotation[9], float translation[3],
+                                                   float distortion_dst[5], float camera_dst[4])
+        {
+            double u, v;
+            float zPlane;
+
+            if (depth == 0)
+            {
+                if(camera_dst)
+                {
+                    dst[0] = -1.f;
+                    dst[1] = -1.f;
+                }
+                else
+                {
+                    dst[0] = 0.f;
+                    dst[1] = 0.f;
+                    dst[2] = 0.f;
+                }
+                return true;
+            }
+
+            zPlane = static_cast<float>(depth);
+            dst[0] = uv->x * zPlane;
+            dst[1] = uv->y * zPlane;
+
+            if(rotation)
+            {
+                float tmp0 = rotation[0] * dst[0] + rotation[1] * dst[1] + rotation[2] * zPlane;
+                float tmp1 = rotation[3] * dst[0] + rotation[4] * dst[1] + rotation[5] * zPlane;
+                zPlane     = rotation[6] * dst[0] + rotation[7] * dst[1] + rotation[8] * zPlane;
+                dst[0] = tmp0;
+                dst[1] = tmp1;
+            }
+
+            if(translation)
+            {
+                dst[0] += translation[0];
+                dst[1] += translation[1];
+                zPlane += translation[2];
+            }
+
+            if(camera_dst)
+            {
+                if ( abs(zPlane) <= MINABS_32F )
+                {
+                    dst[0] = dst[1] = 0.f;
+                    return false;
+                }
+
+                u = v = 1.f / zPlane;
+                u *= dst[0];
+                v *= dst[1];
+
+                if( distortion_dst )
+                {
+                    double r2  = u * u + v * v;
+                    double r4  = r2 * r2;
+                    double fDist = 1.f + distortion_dst[0] * r2 + distortion_dst[1] * r4 + distortion_dst[4] * r2 * r4;
+                    if( distortion_dst[2] != 0 )
+                    {
+                        r4  = 2.f * u * v;
+                        u = u * fDist + distortion_dst[2] * r4 + distortion_dst[3] * (r2 + 2.f * u * u);
+                        v = v * fDist + distortion_dst[3] * r4 + distortion_dst[2] * (r2 + 2.f * v * v);
+                    }
+                    else
+                    {
+                        u *= fDist;
+                        v *= fDist;
+                    }
+                }
+
+                dst[0] = static_cast<float>(u * camera_dst[0] + camera_dst[1]);
+                dst[1] = static_cast<float>(v * camera_dst[2] + camera_dst[3]);
+            }
+            else
+            {
+                dst[2] = zPlane;
+            }
+            return true;
+        }
+
+        projection_row_kernel select_projection_row_kernel()
+        {
+#if defined(PROJECTION_SIMD) && defined(__GNUC__)
+            __builtin_cpu_init();
+            if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return projection_row_16u32f_avx2;
+            if(__builtin_cpu_supports("sse4.1"))
+                return projection_row_16u32f_sse41;
+#endif
+            return nullptr;
+        }
+
         //Added
-        #pragma vector
         status REFCALL math_projection::rs_projection_16u32f_c1cxr(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
                 float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec)
+        {
+            return projection_16u32f_c1cxr(psrc, roi_size, src_step, pdst, dst_step, 0, roi_size.height, rotation, translation, distortion_dst, camera_dst, pspec, m_projection_row_kernel);
+        }
+
+        status REFCALL math_projection::rs_projection_16u32f_c1cxr_rows(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                int first_row, int rows_count, float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec)
+        {
+            return projection_16u32f_c1cxr(psrc, roi_size, src_step, pdst, dst_step, first_row, rows_count, rotation, translation, distortion_dst, camera_dst, pspec, m_projection_row_kernel);
+        }
+
+        status REFCALL math_projection::rs_projection_16u32f_c1cxr_ref(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec)
+        {
+            return projection_16u32f_c1cxr(psrc, roi_size, src_step, pdst, dst_step, 0, roi_size.height, rotation, translation, distortion_dst, camera_dst, pspec, nullptr);
+        }
+
+        status REFCALL math_projection::rs_projection_16u32f_c1cxr_kernel(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec,
+                projection_row_kernel row_kernel)
+        {
+            return projection_16u32f_c1cxr(psrc, roi_size, src_step, pdst, dst_step, 0, roi_size.height, rotation, translation, distortion_dst, camera_dst, pspec, row_kernel);
+        }
+
+        #pragma vector
+        status math_projection::projection_16u32f_c1cxr(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                int first_row, int rows_count, float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec,
+                projection_row_kernel row_kernel)
         {
             if(psrc == 0 || pdst == 0 || pspec == 0) return status::status_handle_invalid;
             if (roi_size.width <= 0 || roi_size.height <= 0) return status::status_data_not_initialized;
 
             sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
             if( roi_size.width != context_roi_size.width || roi_size.height != context_roi_size.height ) return status::status_param_unsupported ;
+            if (first_row < 0 || rows_count < 0 || first_row + rows_count > roi_size.height) return status::status_param_unsupported;
             status sts = status::status_no_error;
 
-            double u, v;
-            float zPlane;
             int dstPi_x = 3;
             if(camera_dst) dstPi_x = 2;
 
             unsigned char* pbuffer = (unsigned char*)pspec + sizeof(float) * 16;
-            pointF32 *rowUV = (pointF32*)pbuffer;
+            pointF32 *rowUV = (pointF32*)pbuffer + first_row * roi_size.width;
+            psrc = (const unsigned short*)((const unsigned char*)psrc + first_row * src_step);
 
-            for (int y = 0; y < roi_size.height; ++y)
+            //the vectorized kernels get the missing transformations as identity, the scalar tail keeps the original parameters
+            projection_row_params params = {};
+            if(row_kernel)
             {
-                float* dst = (float*)((unsigned char*)pdst + y * dst_step);
-                unsigned short* src_value = (unsigned short*)psrc;
-                for (int x = 0; x < roi_size.width; ++x, rowUV++, dst += dstPi_x)
+                const float identity[9] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+                memcpy(params.rotation, rotation ? rotation : identity, sizeof(params.rotation));
+                if(translation) memcpy(params.translation, translation, sizeof(params.translation));
+                if(camera_dst) memcpy(params.camera, camera_dst, sizeof(params.camera));
+                if(distortion_dst)
                 {
-                    if (src_value[x] == 0)
-                    {
-                        if(camera_dst)
-                        {
-                            dst[0] = -1.f;
-                            dst[1] = -1.f;
-                        }
-                        else
-                        {
-                            dst[0] = 0.f;
-                            dst[1] = 0.f;
-                            dst[2] = 0.f;
-                        }
-                        continue;
-                    }
-
-                    zPlane = static_cast<float>(src_value[x]);
-                    dst[0] = rowUV->x * zPlane;
-                    dst[1] = rowUV->y * zPlane;
-
-                    if(rotation)
-                    {
-                        float tmp0 = rotation[0] * dst[0] + rotation[1] * dst[1] + rotation[2] * zPlane;
-                        float tmp1 = rotation[3] * dst[0] + rotation[4] * dst[1] + rotation[5] * zPlane;
-                        zPlane     = rotation[6] * dst[0] + rotation[7] * dst[1] + rotation[8] * zPlane;
-                        dst[0] = tmp0;
-                        dst[1] = tmp1;
-                    }
-
-                    if(translation)
-                    {
-                        dst[0] += translation[0];
-                        dst[1] += translation[1];
-                        zPlane += translation[2];
-                    }
-
-                    if(camera_dst)
-                    {
-                        if ( abs(zPlane) <= MINABS_32F )
-                        {
-                            dst[0] = dst[1] = 0.f;
-                            sts = status::status_handle_invalid;
-                            continue;
-                        }
-
-                        u = v = 1.f / zPlane;
-                        u *= dst[0];
-                        v *= dst[1];
-
-                        if( distortion_dst )
-                        {
-                            double r2  = u * u + v * v;
-                            double r4  = r2 * r2;
-                            double fDist = 1.f + distortion_dst[0] * r2 + distortion_dst[1] * r4 + distortion_dst[4] * r2 * r4;
-                            if( distortion_dst[2] != 0 )
-                            {
-                                r4  = 2.f * u * v;
-                                u = u * fDist + distortion_dst[2] * r4 + distortion_dst[3] * (r2 + 2.f * u * u);
-                                v = v * fDist + distortion_dst[3] * r4 + distortion_dst[2] * (r2 + 2.f * v * v);
-                            }
-                            else
-                            {
-                                u *= fDist;
-                                v *= fDist;
-                            }
-                        }
+                    memcpy(params.distortion, distortion_dst, sizeof(params.distortion));
+                    if(distortion_dst[2] == 0) params.distortion[3] = 0.f;
+                }
+                params.is_distorted = distortion_dst != nullptr;
+                params.is_projected = camera_dst != nullptr;
+            }
 
-                        dst[0] = static_cast<float>(u * camera_dst[0] + camera_dst[1]);
-                        dst[1] = static_cast<float>(v * camera_dst[2] + camera_dst[3]);
-                    }
-                    else
-                    {
-                        dst[2] = zPlane;
-                    }
+            for (int y = first_row; y < first_row + rows_count; ++y)
+            {
+                float* dst = (float*)((unsigned char*)pdst + y * dst_step);
+                const unsigned short* src_value = psrc;
+                int x = 0;
+                if(row_kernel)
+                {
+                    bool invalid_depth = false;
+                    x = row_kernel(src_value, rowUV, dst, roi_size.width, params, invalid_depth);
+                    if(invalid_depth) sts = status::status_handle_invalid;
+                    rowUV += x;
+                    dst += x * dstPi_x;
+                }
+                for (; x < roi_size.width; ++x, rowUV++, dst += dstPi_x)
+                {
+                    if(!projection_16u32f_pixel(src_value[x], rowUV, dst, rotation, translation, distortion_dst, camera_dst))
+                        sts = status::status_handle_invalid;
                 }
                 psrc  = (unsigned short*)((unsigned char*)psrc + src_step);
             }
@@ -394,23 +680,146 @@ namespace rs
             return status::status_no_error;
         }
 
+        status REFCALL math_projection::rs_remap_8u_cnr(const unsigned char* psrc, sizeI32 src_size, int src_step, int channels, const float* pxy_map,
+                int xy_map_step, unsigned char* pdst, sizeI32 dst_roi_size,
+                int dst_step, int interpolation_type, unsigned char default_value)
+        {
+            int x, y, c;
+            if (psrc == 0 || pdst == 0 || pxy_map == 0) return status::status_handle_invalid;
+            if (src_size.width <= 0 || src_size.height <= 0 || dst_roi_size.width <= 0 || dst_roi_size.height <= 0) return status::status_data_not_initialized;
+            if (channels <= 0 || channels > 4) return status::status_param_unsupported;
+            if (interpolation_type != 0 && interpolation_type != 1) return status::status_data_not_initialized;
+
+            const float max_x = (float)(src_size.width - 1);
+            const float max_y = (float)(src_size.height - 1);
+            for (y = 0; y < dst_roi_size.height; y++)
+            {
+                unsigned char* dst = pdst;
+                for (x = 0; x < dst_roi_size.width; x++, dst += channels)
+                {
+                    const float* xy = pxy_map + x * 2;
+                    if (interpolation_type == 0)
+                    {
+                        int sx = (int)(xy[0] + (1.5)) - 1; /* same half-down rounding as rs_remap_16u_c1r */
+                        int sy = (int)(xy[1] + (1.5)) - 1;
+                        if (sx >= 0 && sy >= 0 && sx < src_size.width && sy < src_size.height)
+                        {
+                            const unsigned char* src = psrc + sy * src_step + sx * channels;
+                            for (c = 0; c < channels; c++) dst[c] = src[c];
+                        }
+                        else
+                        {
+                            for (c = 0; c < channels; c++) dst[c] = default_value;
+                        }
+                        continue;
+                    }
+
+                    if (!(xy[0] >= 0.f && xy[1] >= 0.f && xy[0] <= max_x && xy[1] <= max_y))
+                    {
+                        for (c = 0; c < channels; c++) dst[c] = default_value;
+                        continue;
+                    }
+                    /* 8 bit fixed point weights, the last row and column are repeated */
+                    int sx = (int)xy[0];
+                    int sy = (int)xy[1];
+                    int wx = (int)((xy[0] - (float)sx) * 256.f + 0.5f);
+                    int wy = (int)((xy[1] - (float)sy) * 256.f + 0.5f);
+                    int dx = sx + 1 < src_size.width ? channels : 0;
+                    int dy = sy + 1 < src_size.height ? src_step : 0;
+                    const unsigned char* src = psrc + sy * src_step + sx * channels;
+                    for (c = 0; c < channels; c++)
+                    {
+                        int top = src[c] * (256 - wx) + src[c + dx] * wx;
+                        int bottom = src[c + dy] * (256 - wx) + src[c + dy + dx] * wx;
+                        dst[c] = (unsigned char)((top * (256 - wy) + bottom * wy + 32768) >> 16);
+                    }
+                }
+                pxy_map = (const float*)((const unsigned char*)pxy_map + xy_map_step);
+                pdst += dst_step;
+            }
+            return status::status_no_error;
+        }
+
+        /* the f-theta model maps the undistorted radius r to the distorted radius atan(2 * r * tan(w / 2)) / w */
+        status REFCALL math_projection::rs_fisheye_distortion_32f_c2ir(float *psrc_dst, int srcdst_step, sizeI32 roi_size,
+                const unsigned short *pdepth, int depth_step, bool is_origin_invalid, float fisheye_coeff, const float camera[4])
+        {
+            if (psrc_dst == 0 || camera == 0) return status::status_handle_invalid;
+            const float w = fisheye_coeff;
+            const bool is_distorted = std::fabs(w) > 1e-6f;
+            const float tan2 = is_distorted ? 2.f * std::tan(w / 2.f) : 1.f;
+            const float inv_w = is_distorted ? 1.f / w : 1.f;
+            const float center_scale = tan2 * inv_w; /* the limit of the scale at r = 0 */
+            for (int y = 0; y < roi_size.height; y++)
+            {
+                float* xy = psrc_dst;
+                for (int x = 0; x < roi_size.width; x++, xy += 2)
+                {
+                    if ((pdepth && pdepth[x] == 0) || (is_origin_invalid && xy[0] == 0.f && xy[1] == 0.f))
+                    {
+                        xy[0] = xy[1] = -1.f;
+                        continue;
+                    }
+                    float r = std::sqrt(xy[0] * xy[0] + xy[1] * xy[1]);
+                    float scale = (is_distorted && r > 1e-7f) ? std::atan(r * tan2) * inv_w / r : center_scale;
+                    xy[0] = xy[0] * scale * camera[0] + camera[1];
+                    xy[1] = xy[1] * scale * camera[2] + camera[3];
+                }
+                psrc_dst = (float*)((unsigned char*)psrc_dst + srcdst_step);
+                if (pdepth) pdepth = (const unsigned short*)((const unsigned char*)pdepth + depth_step);
+            }
+            return status::status_no_error;
+        }
+
+        status REFCALL math_projection::rs_fisheye_undistortion_32f_c3r(const float *psrc, float *pdst, int length, float fisheye_coeff, const float camera[4])
+        {
+            if (psrc == 0 || pdst == 0 || camera == 0) return status::status_handle_invalid;
+            const float w = fisheye_coeff;
+            const bool is_distorted = std::fabs(w) > 1e-6f;
+            const float inv_tan2 = is_distorted ? 1.f / (2.f * std::tan(w / 2.f)) : 1.f;
+            const float center_scale = w * inv_tan2;
+            const float inv_fx = 1.f / camera[0];
+            const float inv_fy = 1.f / camera[2];
+            for (int i = 0; i < length; i++, psrc += 3, pdst += 3)
+            {
+                float z = psrc[2];
+                float x = (psrc[0] - camera[1]) * inv_fx;
+                float y = (psrc[1] - camera[3]) * inv_fy;
+                float rd = std::sqrt(x * x + y * y);
+                float scale = !is_distorted ? 1.f : rd > 1e-7f ? std::tan(w * rd) * inv_tan2 / rd : center_scale;
+                pdst[0] = x * scale * z;
+                pdst[1] = y * scale * z;
+                pdst[2] = z;
+            }
+            return status::status_no_error;
+        }
+
         //Added
         status REFCALL math_projection::rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, sizeI32 src_size, rect src_roi,
                 float *pdst, int dst_step, sizeI32 dst_size, int units_is_relative, pointF32 threshold)
         {
             rect uvinv_roi = {0, 0, dst_size.width, dst_size.height};
+            return rs_uvmap_invertor_32f_c2r(psrc, src_step, src_size, src_roi, pdst, dst_step, dst_size, uvinv_roi, units_is_relative, threshold);
+        }
+
+        status REFCALL math_projection::rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, sizeI32 src_size, rect src_roi,
+                float *pdst, int dst_step, sizeI32 dst_size, rect dst_roi, int units_is_relative, pointF32 threshold)
+        {
+            if (dst_roi.x < 0 || dst_roi.y < 0 || dst_roi.x + dst_roi.width > dst_size.width || dst_roi.y + dst_roi.height > dst_size.height)
+                return status::status_param_unsupported;
             int i, j;
-            float *dst = pdst;
+            float *dst = (float*)((unsigned char*)pdst + dst_roi.y * dst_step) + dst_roi.x * 2;
 
-            for (i = 0; i < dst_size.height; ++i)
+            for (i = 0; i < dst_roi.height; ++i)
             {
-                for (j = 0; j < dst_size.width * 2; ++j)
+                for (j = 0; j < dst_roi.width * 2; ++j)
                 {
                     dst[j] = -1.f;
                 }
                 dst = (float*)((unsigned char*)dst + dst_step);
             }
-            return r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step, dst_size, uvinv_roi, units_is_relative, threshold);
+            //pixels outside the destination roi aren't written, so separate rois of the same map may be inverted concurrently
+            return r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step, dst_size, dst_roi, units_is_relative, threshold);
         }
 
         status REFCALL math_projection::rs_qr_decomp_m_64f(const double* psrc, int src_stride1, int src_stride2, double* pbuffer,
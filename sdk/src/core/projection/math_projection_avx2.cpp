@@ -0,0 +1,98 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+//this file is compiled with avx2 and fma code generation, its functions are called only if the cpu supports both.
+
+#include <immintrin.h>
+#include "math_projection_simd.h"
+
+namespace rs
+{
+    namespace core
+    {
+        int projection_row_16u32f_avx2(const unsigned short *src, const pointF32 *uv, float *dst, int width,
+                                       const projection_row_params &params, bool &invalid_depth)
+        {
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.f);
+            const __m256 two = _mm256_set1_ps(2.f);
+            const __m256 minus_one = _mm256_set1_ps(-1.f);
+            const __m256 min_abs = _mm256_set1_ps(1.175494351e-38f);
+            const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+            const float *r = params.rotation;
+            const float *t = params.translation;
+            const float *d = params.distortion;
+            const float *c = params.camera;
+
+            int invalid_mask = 0;
+            int x = 0;
+            for(; x + 8 <= width; x += 8, uv += 8)
+            {
+                //8 depth values and the matching 8 interleaved uv pairs
+                __m256 z = _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x))));
+                __m256 uv0 = _mm256_loadu_ps(reinterpret_cast<const float*>(uv));
+                __m256 uv1 = _mm256_loadu_ps(reinterpret_cast<const float*>(uv + 4));
+                __m256 u = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(uv0, uv1, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+                __m256 v = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(uv0, uv1, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+                __m256 no_depth = _mm256_cmp_ps(z, zero, _CMP_EQ_OQ);
+
+                __m256 px = _mm256_mul_ps(u, z);
+                __m256 py = _mm256_mul_ps(v, z);
+                __m256 pz = _mm256_fmadd_ps(_mm256_set1_ps(r[6]), px, _mm256_fmadd_ps(_mm256_set1_ps(r[7]), py, _mm256_fmadd_ps(_mm256_set1_ps(r[8]), z, _mm256_set1_ps(t[2]))));
+                __m256 tx = _mm256_fmadd_ps(_mm256_set1_ps(r[0]), px, _mm256_fmadd_ps(_mm256_set1_ps(r[1]), py, _mm256_fmadd_ps(_mm256_set1_ps(r[2]), z, _mm256_set1_ps(t[0]))));
+                __m256 ty = _mm256_fmadd_ps(_mm256_set1_ps(r[3]), px, _mm256_fmadd_ps(_mm256_set1_ps(r[4]), py, _mm256_fmadd_ps(_mm256_set1_ps(r[5]), z, _mm256_set1_ps(t[1]))));
+
+                if(!params.is_projected)
+                {
+                    alignas(32) float vx[8], vy[8], vz[8];
+                    _mm256_store_ps(vx, _mm256_blendv_ps(tx, zero, no_depth));
+                    _mm256_store_ps(vy, _mm256_blendv_ps(ty, zero, no_depth));
+                    _mm256_store_ps(vz, _mm256_blendv_ps(pz, zero, no_depth));
+                    for(int i = 0; i < 8; i++, dst += 3)
+                    {
+                        dst[0] = vx[i];
+                        dst[1] = vy[i];
+                        dst[2] = vz[i];
+                    }
+                    continue;
+                }
+
+                //lanes with a valid source depth and a zero transformed depth are reported, same as the scalar projection
+                __m256 no_plane = _mm256_cmp_ps(_mm256_and_ps(pz, abs_mask), min_abs, _CMP_LE_OQ);
+                invalid_mask |= _mm256_movemask_ps(_mm256_andnot_ps(no_depth, no_plane));
+
+                __m256 inv_z = _mm256_div_ps(one, pz);
+                u = _mm256_mul_ps(tx, inv_z);
+                v = _mm256_mul_ps(ty, inv_z);
+                if(params.is_distorted)
+                {
+                    __m256 r2 = _mm256_fmadd_ps(u, u, _mm256_mul_ps(v, v));
+                    __m256 radial = _mm256_fmadd_ps(r2, _mm256_fmadd_ps(r2, _mm256_fmadd_ps(r2, _mm256_set1_ps(d[4]), _mm256_set1_ps(d[1])), _mm256_set1_ps(d[0])), one);
+                    __m256 uv2 = _mm256_mul_ps(two, _mm256_mul_ps(u, v));
+                    __m256 p1 = _mm256_set1_ps(d[2]);
+                    __m256 p2 = _mm256_set1_ps(d[3]);
+                    __m256 du = _mm256_fmadd_ps(p1, uv2, _mm256_mul_ps(p2, _mm256_fmadd_ps(two, _mm256_mul_ps(u, u), r2)));
+                    __m256 dv = _mm256_fmadd_ps(p2, uv2, _mm256_mul_ps(p1, _mm256_fmadd_ps(two, _mm256_mul_ps(v, v), r2)));
+                    u = _mm256_fmadd_ps(u, radial, du);
+                    v = _mm256_fmadd_ps(v, radial, dv);
+                }
+                u = _mm256_fmadd_ps(u, _mm256_set1_ps(c[0]), _mm256_set1_ps(c[1]));
+                v = _mm256_fmadd_ps(v, _mm256_set1_ps(c[2]), _mm256_set1_ps(c[3]));
+                u = _mm256_blendv_ps(_mm256_blendv_ps(u, zero, no_plane), minus_one, no_depth);
+                v = _mm256_blendv_ps(_mm256_blendv_ps(v, zero, no_plane), minus_one, no_depth);
+
+                //interleave back to 8 uv pairs
+                __m256 lo = _mm256_unpacklo_ps(u, v);
+                __m256 hi = _mm256_unpackhi_ps(u, v);
+                _mm256_storeu_ps(dst, _mm256_permute2f128_ps(lo, hi, 0x20));
+                _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+                dst += 16;
+            }
+
+            if(invalid_mask)
+                invalid_depth = true;
+            return x;
+        }
+    }
+}
@@ -5,6 +5,7 @@
 #include "rs/core/status.h"
 #include "rs/core/types.h"
 #include "math.h"
+#include "math_projection_simd.h"
 
 namespace rs
 {
@@ -27,22 +28,65 @@ namespace rs
                     float inv_distortion_src[5], float rotation[9], float translation[3],
                     float distortion_dst[5], float camera_dst[4]);
 
+            /* structure of arrays variant of rs_3d_array_projection_32f, the arrays must not overlap. pdst_z isn't written if the points are projected to camera_dst */
+            rs::core::status REFCALL rs_3d_array_projection_soa_32f(const float *psrc_x, const float *psrc_y, const float *psrc_z,
+                    float *pdst_x, float *pdst_y, float *pdst_z, int length, float camera_src[4],
+                    float inv_distortion_src[5], float rotation[9], float translation[3],
+                    float distortion_dst[5], float camera_dst[4]);
+
+            /* double precision reference of rs_3d_array_projection_32f, which runs the float projection specialized for the given stages */
+            rs::core::status REFCALL rs_3d_array_projection_32f_ref(const float *psrc, float *pdst, int length, float camera_src[4],
+                    float inv_distortion_src[5], float rotation[9], float translation[3],
+                    float distortion_dst[5], float camera_dst[4]);
+
             rs::core::status REFCALL rs_projection_16u32f_c1cxr(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
                     float rotation[9], float translation[3], float distortion_dst[5],
                     float camera_dst[4], const projection_spec_32f *pspec);
 
+            /* scalar reference of rs_projection_16u32f_c1cxr, which runs the vectorized row kernel supported by the cpu */
+            rs::core::status REFCALL rs_projection_16u32f_c1cxr_ref(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                    float rotation[9], float translation[3], float distortion_dst[5],
+                    float camera_dst[4], const projection_spec_32f *pspec);
+
+            /* rs_projection_16u32f_c1cxr with the given row kernel, nullptr runs the scalar reference. the kernel must be supported by the cpu */
+            rs::core::status REFCALL rs_projection_16u32f_c1cxr_kernel(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                    float rotation[9], float translation[3], float distortion_dst[5],
+                    float camera_dst[4], const projection_spec_32f *pspec, projection_row_kernel row_kernel);
+
+            /* projects only the rows [first_row, first_row + rows_count) of the roi, separate rows of the same image may be projected concurrently */
+            rs::core::status REFCALL rs_projection_16u32f_c1cxr_rows(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                    int first_row, int rows_count, float rotation[9], float translation[3], float distortion_dst[5],
+                    float camera_dst[4], const projection_spec_32f *pspec);
+
             rs::core::status REFCALL rs_projection_get_size_32f(rs::core::sizeI32 roi_size, int *pspec_size);
 
             rs::core::status REFCALL rs_remap_16u_c1r(const unsigned short* psrc, rs::core::sizeI32 src_size, int src_step, const float* pxy_map,
                     int xy_map_step, unsigned short* pdst, rs::core::sizeI32 dstroi_size,
                     int dst_step, int interpolation_type, unsigned short default_value);
 
+            /* nearest (interpolation_type 0) or bilinear (interpolation_type 1) remap of an image with 8 bit channels */
+            rs::core::status REFCALL rs_remap_8u_cnr(const unsigned char* psrc, rs::core::sizeI32 src_size, int src_step, int channels, const float* pxy_map,
+                    int xy_map_step, unsigned char* pdst, rs::core::sizeI32 dstroi_size,
+                    int dst_step, int interpolation_type, unsigned char default_value);
+
+            /* applies the f-theta fisheye distortion and the camera to normalized undistorted points, in place.
+               points of a zero depth pixel are set to -1 if pdepth isn't null, and the (0, 0) points the projection kernels
+               write for the points on the camera plane are set to -1 if is_origin_invalid is set */
+            rs::core::status REFCALL rs_fisheye_distortion_32f_c2ir(float *psrc_dst, int srcdst_step, rs::core::sizeI32 roi_size,
+                    const unsigned short *pdepth, int depth_step, bool is_origin_invalid, float fisheye_coeff, const float camera[4]);
+
+            /* removes the camera and the f-theta fisheye distortion of (x, y, depth) pixels, the results are 3d points of the fisheye camera */
+            rs::core::status REFCALL rs_fisheye_undistortion_32f_c3r(const float *psrc, float *pdst, int length, float fisheye_coeff, const float camera[4]);
+
             rs::core::status REFCALL rs_uvmap_filter_32f_c2ir(float *psrc_dst, int srcdst_step, rs::core::sizeI32 roi_size,
                     const unsigned short *pdepth, int depth_step, unsigned short invalid_depth);
 
             rs::core::status REFCALL rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, rs::core::sizeI32 src_size, rs::core::rect src_roi,
                     float *pdst, int dst_step, rs::core::sizeI32 dst_size, int units_is_relative, pointF32  threshold);
 
+            rs::core::status REFCALL rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, rs::core::sizeI32 src_size, rs::core::rect src_roi,
+                    float *pdst, int dst_step, rs::core::sizeI32 dst_size, rs::core::rect dst_roi, int units_is_relative, pointF32  threshold);
+
             rs::core::status REFCALL rs_qr_decomp_m_64f(const double*  psrc,  int src_stride1, int src_stride2,
                     double*  pbuffer,
                     double*  pdst,  int dststride1, int dststride2,
@@ -51,6 +95,13 @@ namespace rs
             rs::core::status REFCALL rs_qr_back_subst_mva_64f(const double*  psrc1,  int src1stride1, int src1stride2, double*  pbuffer,
                     const double*  psrc2,  int src2stride0, int src2stride2,
                     double*  pdst,   int dststride0,  int dststride2, int width, int height, int count);
+
+        private:
+            rs::core::status projection_16u32f_c1cxr(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                    int first_row, int rows_count, float rotation[9], float translation[3], float distortion_dst[5],
+                    float camera_dst[4], const projection_spec_32f *pspec, projection_row_kernel row_kernel);
+
+            projection_row_kernel m_projection_row_kernel;
         };
     }
 }
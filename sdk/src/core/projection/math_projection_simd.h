@@ -0,0 +1,56 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include "rs/core/types.h"
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Per call parameters of the depth image projection, shared by the scalar and the vectorized row kernels.
+        *
+        * Missing rotation, translation and distortion are replaced by the identity transformation,
+        * so the vectorized kernels don't branch per pixel.
+        */
+        struct projection_row_params
+        {
+            float rotation[9];
+            float translation[3];
+            float distortion[5];    /**< the tangential coefficients are zeroed if the first one is 0, same as the scalar projection */
+            float camera[4];
+            bool  is_distorted;
+            bool  is_projected;     /**< true to project to the destination camera pixels, false to return the camera coordinates */
+        };
+
+        /**
+        * @brief Vectorized projection of a single depth image row.
+        *
+        * Processes the row pixels in blocks, the remaining pixels are left for the scalar projection.
+        * @param[in]  src           Depth row
+        * @param[in]  uv            Undistorted normalized source camera coordinates of the row pixels
+        * @param[out] dst           Destination row, 2 floats per pixel if the pixels are projected, 3 floats otherwise
+        * @param[in]  width         Row width
+        * @param[in]  params        Projection parameters
+        * @param[out] invalid_depth Set to true if a pixel has a zero depth after the transformation
+        * @return int Number of processed pixels
+        */
+        typedef int (*projection_row_kernel)(const unsigned short *src, const pointF32 *uv, float *dst, int width,
+                                             const projection_row_params &params, bool &invalid_depth);
+
+#ifdef PROJECTION_SIMD
+        int projection_row_16u32f_sse41(const unsigned short *src, const pointF32 *uv, float *dst, int width,
+                                        const projection_row_params &params, bool &invalid_depth);
+        int projection_row_16u32f_avx2(const unsigned short *src, const pointF32 *uv, float *dst, int width,
+                                       const projection_row_params &params, bool &invalid_depth);
+#endif
+
+        /**
+        * @brief Selects the fastest row kernel supported by the running cpu.
+        *
+        * @return projection_row_kernel Vectorized row kernel, nullptr if none is supported
+        */
+        projection_row_kernel select_projection_row_kernel();
+    }
+}
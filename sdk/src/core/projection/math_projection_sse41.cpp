@@ -0,0 +1,96 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+//this file is compiled with sse4.1 code generation, its functions are called only if the cpu supports it.
+
+#include <smmintrin.h>
+#include "math_projection_simd.h"
+
+namespace rs
+{
+    namespace core
+    {
+        int projection_row_16u32f_sse41(const unsigned short *src, const pointF32 *uv, float *dst, int width,
+                                        const projection_row_params &params, bool &invalid_depth)
+        {
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.f);
+            const __m128 two = _mm_set1_ps(2.f);
+            const __m128 minus_one = _mm_set1_ps(-1.f);
+            const __m128 min_abs = _mm_set1_ps(1.175494351e-38f);
+            const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+            const float *r = params.rotation;
+            const float *t = params.translation;
+            const float *d = params.distortion;
+            const float *c = params.camera;
+
+            int invalid_mask = 0;
+            int x = 0;
+            for(; x + 4 <= width; x += 4, uv += 4)
+            {
+                //4 depth values and the matching 4 interleaved uv pairs
+                __m128 z = _mm_cvtepi32_ps(_mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + x))));
+                __m128 uv0 = _mm_loadu_ps(reinterpret_cast<const float*>(uv));
+                __m128 uv1 = _mm_loadu_ps(reinterpret_cast<const float*>(uv + 2));
+                __m128 u = _mm_shuffle_ps(uv0, uv1, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 v = _mm_shuffle_ps(uv0, uv1, _MM_SHUFFLE(3, 1, 3, 1));
+                __m128 no_depth = _mm_cmpeq_ps(z, zero);
+
+                __m128 px = _mm_mul_ps(u, z);
+                __m128 py = _mm_mul_ps(v, z);
+                __m128 tx = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[0]), px), _mm_mul_ps(_mm_set1_ps(r[1]), py)), _mm_mul_ps(_mm_set1_ps(r[2]), z)), _mm_set1_ps(t[0]));
+                __m128 ty = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[3]), px), _mm_mul_ps(_mm_set1_ps(r[4]), py)), _mm_mul_ps(_mm_set1_ps(r[5]), z)), _mm_set1_ps(t[1]));
+                __m128 pz = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[6]), px), _mm_mul_ps(_mm_set1_ps(r[7]), py)), _mm_mul_ps(_mm_set1_ps(r[8]), z)), _mm_set1_ps(t[2]));
+
+                if(!params.is_projected)
+                {
+                    alignas(16) float vx[4], vy[4], vz[4];
+                    _mm_store_ps(vx, _mm_blendv_ps(tx, zero, no_depth));
+                    _mm_store_ps(vy, _mm_blendv_ps(ty, zero, no_depth));
+                    _mm_store_ps(vz, _mm_blendv_ps(pz, zero, no_depth));
+                    for(int i = 0; i < 4; i++, dst += 3)
+                    {
+                        dst[0] = vx[i];
+                        dst[1] = vy[i];
+                        dst[2] = vz[i];
+                    }
+                    continue;
+                }
+
+                //lanes with a valid source depth and a zero transformed depth are reported, same as the scalar projection
+                __m128 no_plane = _mm_cmple_ps(_mm_and_ps(pz, abs_mask), min_abs);
+                invalid_mask |= _mm_movemask_ps(_mm_andnot_ps(no_depth, no_plane));
+
+                __m128 inv_z = _mm_div_ps(one, pz);
+                u = _mm_mul_ps(tx, inv_z);
+                v = _mm_mul_ps(ty, inv_z);
+                if(params.is_distorted)
+                {
+                    __m128 r2 = _mm_add_ps(_mm_mul_ps(u, u), _mm_mul_ps(v, v));
+                    __m128 radial = _mm_add_ps(one, _mm_mul_ps(r2, _mm_add_ps(_mm_set1_ps(d[0]), _mm_mul_ps(r2, _mm_add_ps(_mm_set1_ps(d[1]), _mm_mul_ps(r2, _mm_set1_ps(d[4])))))));
+                    __m128 uv2 = _mm_mul_ps(two, _mm_mul_ps(u, v));
+                    __m128 p1 = _mm_set1_ps(d[2]);
+                    __m128 p2 = _mm_set1_ps(d[3]);
+                    __m128 du = _mm_add_ps(_mm_mul_ps(p1, uv2), _mm_mul_ps(p2, _mm_add_ps(r2, _mm_mul_ps(two, _mm_mul_ps(u, u)))));
+                    __m128 dv = _mm_add_ps(_mm_mul_ps(p2, uv2), _mm_mul_ps(p1, _mm_add_ps(r2, _mm_mul_ps(two, _mm_mul_ps(v, v)))));
+                    u = _mm_add_ps(_mm_mul_ps(u, radial), du);
+                    v = _mm_add_ps(_mm_mul_ps(v, radial), dv);
+                }
+                u = _mm_add_ps(_mm_mul_ps(u, _mm_set1_ps(c[0])), _mm_set1_ps(c[1]));
+                v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(c[2])), _mm_set1_ps(c[3]));
+                u = _mm_blendv_ps(_mm_blendv_ps(u, zero, no_plane), minus_one, no_depth);
+                v = _mm_blendv_ps(_mm_blendv_ps(v, zero, no_plane), minus_one, no_depth);
+
+                //interleave back to 4 uv pairs
+                _mm_storeu_ps(dst, _mm_unpacklo_ps(u, v));
+                _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(u, v));
+                dst += 8;
+            }
+
+            if(invalid_mask)
+                invalid_depth = true;
+            return x;
+        }
+    }
+}
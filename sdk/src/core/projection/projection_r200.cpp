@@ -2,6 +2,13 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <cstring>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
 
 #include "projection_r200.h"
 #pragma warning (disable : 4068)
@@ -15,20 +22,237 @@ using namespace rs::core;
 static void *aligned_malloc(size_t size);
 static void aligned_free(void *ptr);
 
-#define x64_ALIGNMENT(x) (((x)+0x3f)&0xffffffc0)
-
 
 namespace rs
 {
     namespace core
     {
+        namespace
+        {
+            // the color pixel neighbourhood searched by map_color_to_depth, ordered by the distance from the pixel
+            std::vector<pointI32> color_to_depth_search_steps()
+            {
+                const int32_t max_size = 25;
+                const int niter = 2;
+                std::vector<pointI32> steps;
+                steps.reserve(max_size);
+                steps.push_back({0, 0});
+                for(int i = 1; i <= niter; i++)
+                {
+                    steps.push_back({0, i});
+                    steps.push_back({-i, 0});
+                    steps.push_back({i, 0});
+                    steps.push_back({0, -i});
+                    for(int j = 1; j <= i - 1; j++)
+                    {
+                        steps.push_back({-j, i});
+                        steps.push_back({j, i});
+
+                        steps.push_back({-i, j});
+                        steps.push_back({i, j});
+
+                        steps.push_back({-i, -j});
+                        steps.push_back({i, -j});
+
+                        steps.push_back({-j, -i});
+                        steps.push_back({j, -i});
+                    }
+                    steps.push_back({-i, i});
+                    steps.push_back({i, i});
+                    steps.push_back({-i, -i});
+                    steps.push_back({i, -i});
+                }
+                return steps;
+            }
+
+            // the calibration inputs of the projection initialization, all the members are 4 bytes wide so the key has no padding
+            struct calibration_key
+            {
+                sizeI32            depth_size;
+                sizeI32            color_size;
+                int32_t            is_color_rectified;
+                int32_t            is_mirrored;
+                int32_t            is_color_fisheye;
+                float              fisheye_coeff;
+                stream_calibration depth_calib;
+                stream_calibration color_calib;
+                stream_transform   depth_transform;
+            };
+
+            // the data which is derived from the calibration by the projection initialization
+            struct calibration_data
+            {
+                std::shared_ptr<const uint8_t> projection_spec;
+                float invrot_color[9];
+                float invtrans_color[3];
+                float invdist_color_coeffs[5];
+            };
+
+            // process wide cache of the derived calibration data, so projections of an already seen camera
+            // share the depth projection spec and skip the least squares fits.
+            // only the projection initialization accesses the cache, the queries don't lock it.
+            class calibration_cache
+            {
+            public:
+                std::shared_ptr<const calibration_data> find(const calibration_key &key)
+                {
+                    uint64_t hash = hash_key(key);
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    for (auto &entry : m_entries)
+                    {
+                        if (entry.hash == hash && memcmp(&entry.key, &key, sizeof(key)) == 0)
+                            return entry.data;
+                    }
+                    return nullptr;
+                }
+
+                void insert(const calibration_key &key, const std::shared_ptr<const calibration_data> &data)
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    if (m_entries.size() >= MAX_ENTRIES)
+                        m_entries.pop_front();
+                    m_entries.push_back({hash_key(key), key, data});
+                }
+
+                static calibration_cache &instance()
+                {
+                    static calibration_cache cache;
+                    return cache;
+                }
+
+            private:
+                static const size_t MAX_ENTRIES = 8;
+
+                struct entry
+                {
+                    uint64_t                                hash;
+                    calibration_key                         key;
+                    std::shared_ptr<const calibration_data> data;
+                };
+
+                static uint64_t hash_key(const calibration_key &key)
+                {
+                    // 64 bit FNV-1a
+                    const uint8_t *bytes = reinterpret_cast<const uint8_t*>(&key);
+                    uint64_t hash = 14695981039346656037ULL;
+                    for (size_t i = 0; i < sizeof(key); i++)
+                    {
+                        hash ^= bytes[i];
+                        hash *= 1099511628211ULL;
+                    }
+                    return hash;
+                }
+
+                std::mutex        m_mutex;
+                std::deque<entry> m_entries;
+            };
+
+            // the uvmap rows of the invertor quads which may be mapped into the color rows band, the rows ranges are given by query_uvmap_rows_range.
+            // a quad of the uvmap rows r and r+1 is written to the color rows of its corners y range, which the invertor rounds to float,
+            // so the quads are tested with a margin of one row.
+            rect invertor_src_roi(const pointF32 *rows_range, sizeI32 uvmap_size, int32_t color_height, int first_row, int rows_count)
+            {
+                int first_quad = uvmap_size.height;
+                int last_quad = -1;
+                for (int r = 0; r < uvmap_size.height - 1; r++)
+                {
+                    const double min_y = std::min(rows_range[r].x, rows_range[r + 1].x) * static_cast<double>(color_height);
+                    const double max_y = std::max(rows_range[r].y, rows_range[r + 1].y) * static_cast<double>(color_height);
+                    if (min_y < first_row + rows_count && max_y > first_row - 1)
+                    {
+                        first_quad = std::min(first_quad, r);
+                        last_quad = r;
+                    }
+                }
+                if (last_quad < 0)
+                    return { 0, 0, uvmap_size.width, 0 };
+                return { 0, first_quad, uvmap_size.width, last_quad - first_quad + 2 };
+            }
+        }
+
+        // the parallel_rows threads, started by the first query which needs them and kept until the instance is released.
+        // the instance may be queried by many threads at once, so each query queues its own job, and its calling thread processes bands too.
+        class ds4_projection::row_workers
+        {
+        public:
+            row_workers() : m_stop(false) {}
+
+            ~row_workers()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    m_stop = true;
+                }
+                m_work_available.notify_all();
+                for (auto & thread : m_threads)
+                    thread.join();
+            }
+
+            // calls process_band for each band of the bands count, returns once all the bands are processed
+            void run(int bands_count, const std::function<void(int band)> &process_band)
+            {
+                job current_job = { &process_band, bands_count, 0, bands_count };
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (static_cast<int>(m_threads.size()) < bands_count - 1)
+                    m_threads.push_back(std::thread(&row_workers::work, this));
+                m_jobs.push_back(&current_job);
+                m_work_available.notify_all();
+                while (current_job.next_band < current_job.bands_count)
+                    process_next_band(current_job, lock);
+                m_job_done.wait(lock, [&current_job] { return current_job.pending_bands == 0; });
+            }
+
+        private:
+            struct job
+            {
+                const std::function<void(int band)> *process_band;
+                int                                  bands_count;
+                int                                  next_band;
+                int                                  pending_bands;
+            };
+
+            // called with the lock held, the job is removed from the queue once its last band is taken
+            void process_next_band(job &current_job, std::unique_lock<std::mutex> &lock)
+            {
+                int band = current_job.next_band++;
+                if (current_job.next_band == current_job.bands_count)
+                    m_jobs.erase(std::find(m_jobs.begin(), m_jobs.end(), &current_job));
+                lock.unlock();
+                (*current_job.process_band)(band);
+                lock.lock();
+                if (--current_job.pending_bands == 0)
+                    m_job_done.notify_all();
+            }
+
+            void work()
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (true)
+                {
+                    m_work_available.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+                    if (m_stop)
+                        return;
+                    process_next_band(*m_jobs.front(), lock);
+                }
+            }
+
+            std::mutex               m_mutex;
+            std::condition_variable  m_work_available;
+            std::condition_variable  m_job_done;
+            std::deque<job*>         m_jobs;
+            std::vector<std::thread> m_threads;
+            bool                     m_stop;
+        };
+
         ds4_projection::ds4_projection(bool platformCameraProjection) :
-            m_buffer(nullptr),
             m_initialize_status(initialize_status::not_initialized),
             m_is_platform_camera_projection(platformCameraProjection),
-            m_projection_spec(nullptr),
-            m_projection_spec_size(0),
-            m_sparse_invuvmap(nullptr)
+            m_threads_count(1),
+            m_row_workers(new row_workers()),
+            m_depth_to_color_registration(depth_to_color_registration::inverse_uvmap),
+            m_step_buffer(color_to_depth_search_steps()),
+            m_color_to_depth_contexts_count(1),
+            m_next_color_to_depth_context(0)
         {
             reset();
         }
@@ -36,23 +260,36 @@ namespace rs
         ds4_projection::~ds4_projection()
         {
             reset();
-            if (m_sparse_invuvmap)
-                delete[] m_sparse_invuvmap;
         }
 
         void ds4_projection::reset()
         {
-            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
             memset(m_distorsion_color_coeffs, 0, sizeof(m_distorsion_color_coeffs));
-            if (m_projection_spec) aligned_free(m_projection_spec);
-            m_projection_spec = nullptr;
-            m_projection_spec_size = 0;
-            if (m_buffer) aligned_free(m_buffer);
-            m_buffer = nullptr;
-            m_buffer_size = 0;
+            m_projection_spec.reset();
+            m_is_color_fisheye = false;
+            m_fisheye_coeff = 0.f;
+            for (auto & cached_context : m_color_to_depth_contexts)
+                std::atomic_store(&cached_context, std::shared_ptr<const color_to_depth_context>());
+            std::atomic_store(&m_color_undistortion_map, std::shared_ptr<const std::vector<pointF32>>());
+            std::lock_guard<std::mutex> guard(m_scratch_mutex);
+            m_free_scratch_sets.clear();
         }
 
         status ds4_projection::init_from_float_array(r200_projection_float_array *data)
+        {
+            m_is_color_fisheye = false;
+            m_fisheye_coeff = 0.f;
+            return load_float_array(data);
+        }
+
+        status ds4_projection::init_from_float_array(r200_projection_float_array *data, float fisheye_coeff)
+        {
+            m_is_color_fisheye = true;
+            m_fisheye_coeff = fisheye_coeff;
+            return load_float_array(data);
+        }
+
+        status ds4_projection::load_float_array(r200_projection_float_array *data)
         {
             m_color_size.width = static_cast<int>(data->color_width);
             m_color_size.height = static_cast<int>(data->color_height);
@@ -117,17 +354,39 @@ namespace rs
             if (flipY)
                 m_camera_depth_params[2] = -m_camera_depth_params[2];
 
-            int projectionSpecSize;
-
-            sizeI32 depthSize = {m_depth_size.width, m_depth_size.height};
-            m_math_projection.rs_projection_get_size_32f(depthSize, &projectionSpecSize);
-            if( m_projection_spec_size < projectionSpecSize)
+            calibration_key key;
+            memset(&key, 0, sizeof(key));
+            key.depth_size = m_depth_size;
+            key.color_size = m_is_color_rectified ? m_color_size_rectified : m_color_size_unrectified;
+            key.is_color_rectified = m_is_color_rectified ? 1 : 0;
+            key.is_mirrored = isMirrored ? 1 : 0;
+            key.is_color_fisheye = m_is_color_fisheye ? 1 : 0;
+            key.fisheye_coeff = m_fisheye_coeff;
+            key.depth_calib = m_depth_calib;
+            key.color_calib = m_color_calib;
+            key.depth_transform = m_depth_transform;
+            std::shared_ptr<const calibration_data> cached_data = calibration_cache::instance().find(key);
+            std::shared_ptr<calibration_data> new_data;
+            if (cached_data)
             {
-                m_projection_spec = (uint8_t*)aligned_malloc(sizeof(uint8_t) * projectionSpecSize);
-                m_projection_spec_size = projectionSpecSize;
-                memset(m_projection_spec, 0, projectionSpecSize);
+                m_projection_spec = cached_data->projection_spec;
+            }
+            else
+            {
+                new_data = std::make_shared<calibration_data>();
+                memset(new_data->invrot_color, 0, sizeof(new_data->invrot_color));
+                memset(new_data->invtrans_color, 0, sizeof(new_data->invtrans_color));
+                memset(new_data->invdist_color_coeffs, 0, sizeof(new_data->invdist_color_coeffs));
+
+                int projectionSpecSize;
+                sizeI32 depthSize = {m_depth_size.width, m_depth_size.height};
+                m_math_projection.rs_projection_get_size_32f(depthSize, &projectionSpecSize);
+                uint8_t *projection_spec = (uint8_t*)aligned_malloc(sizeof(uint8_t) * projectionSpecSize);
+                memset(projection_spec, 0, projectionSpecSize);
+                m_math_projection.rs_projection_init_32f(depthSize, m_camera_depth_params, 0, (projection_spec_32f*)projection_spec);
+                m_projection_spec = std::shared_ptr<const uint8_t>(projection_spec, [](const uint8_t *spec) { aligned_free(const_cast<uint8_t*>(spec)); });
+                new_data->projection_spec = m_projection_spec;
             }
-            m_math_projection.rs_projection_init_32f(depthSize, m_camera_depth_params, 0, (projection_spec_32f*)m_projection_spec);
 
             m_camera_color_params[0] = m_color_calib.focal_length.x;
             m_camera_color_params[1] = m_color_calib.principal_point.x;
@@ -158,7 +417,17 @@ namespace rs
                     m_rotation[4] = -m_rotation[4];
                     m_rotation[5] = -m_rotation[7];
                 }
-                projection_ds_lms12(m_rotation, m_translation, m_invrot_color, m_invtrans_color);
+                if (cached_data)
+                {
+                    memcpy(m_invrot_color, cached_data->invrot_color, sizeof(m_invrot_color));
+                    memcpy(m_invtrans_color, cached_data->invtrans_color, sizeof(m_invtrans_color));
+                }
+                else
+                {
+                    projection_ds_lms12(m_rotation, m_translation, m_invrot_color, m_invtrans_color);
+                    memcpy(new_data->invrot_color, m_invrot_color, sizeof(m_invrot_color));
+                    memcpy(new_data->invtrans_color, m_invtrans_color, sizeof(m_invtrans_color));
+                }
 #pragma novector
                 float distortion[5] =
                 {
@@ -168,9 +437,19 @@ namespace rs
                     m_color_calib.tangential_distortion[1],
                     m_color_calib.radial_distortion[2]
                 };
-                if (memcmp(m_distorsion_color_coeffs, distortion, 5 * sizeof(float)))
+                memcpy(m_distorsion_color_coeffs, distortion, 5 * sizeof(float));
+                if (m_is_color_fisheye)
+                {
+                    // the fisheye distortion is applied by the fisheye kernels, the brown distortion is disabled
+                    memset(m_distorsion_color_coeffs, 0, sizeof(m_distorsion_color_coeffs));
+                    memset(m_invdist_color_coeffs, 0, sizeof(m_invdist_color_coeffs));
+                }
+                else if (cached_data)
+                {
+                    memcpy(m_invdist_color_coeffs, cached_data->invdist_color_coeffs, sizeof(m_invdist_color_coeffs));
+                }
+                else
                 {
-                    memcpy(m_distorsion_color_coeffs, distortion, 5 * sizeof(float));
                     float camera[4] =
                     {
                         m_color_calib.focal_length.x * 2.f / (float)m_color_size_unrectified.width,
@@ -179,9 +458,12 @@ namespace rs
                         m_color_calib.principal_point.y * 2.f / (float)m_color_size_unrectified.height - 1.f
                     };
                     distorsion_ds_lms(camera, m_distorsion_color_coeffs, m_invdist_color_coeffs);
+                    memcpy(new_data->invdist_color_coeffs, m_invdist_color_coeffs, sizeof(m_invdist_color_coeffs));
                 }
             }
 
+            if (new_data)
+                calibration_cache::instance().insert(key, new_data);
             return status::status_no_error;
         }
 
@@ -221,6 +503,12 @@ namespace rs
                 float translationC[3] = {-m_translation[0], -m_translation[1], -m_translation[2]};
                 m_math_projection.rs_3d_array_projection_32f((const float*)pos_ijz, (float*)pos3d, npoints, m_camera_color_params, 0, 0, translationC, 0, 0);
             }
+            else if (m_is_color_fisheye)
+            {
+                // the pixels are undistorted to the fisheye camera points, which are transformed in place to the depth camera
+                m_math_projection.rs_fisheye_undistortion_32f_c3r((const float*)pos_ijz, (float*)pos3d, npoints, m_fisheye_coeff, m_camera_color_params);
+                m_math_projection.rs_3d_array_projection_32f((const float*)pos3d, (float*)pos3d, npoints, 0, 0, m_invrot_color, m_invtrans_color, 0, 0);
+            }
             else
             {
                 m_math_projection.rs_3d_array_projection_32f((const float*)pos_ijz, (float*)pos3d, npoints, m_camera_color_params, m_invdist_color_coeffs, m_invrot_color, m_invtrans_color, 0, 0);
@@ -235,24 +523,32 @@ namespace rs
             if (!pos3d) return status::status_handle_invalid;
             if (!pos_ij) return status::status_handle_invalid;
             if (!(m_initialize_status & initialize_status::color_initialized)) return status::status_data_unavailable;
+            if (project_to_color((const float*)pos3d, (float*)pos_ij, npoints, nullptr, m_camera_color_params) != status::status_no_error)
+            {
+                return status::status_param_unsupported;
+            }
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::project_to_color(const float *psrc, float *pdst, int32_t npoints, float *camera_src, float *camera_dst)
+        {
             if (m_is_color_rectified)
             {
-                status result = m_math_projection.rs_3d_array_projection_32f((const float*)pos3d, (float*)pos_ij, npoints, nullptr, nullptr, nullptr, m_translation, nullptr, m_camera_color_params);
-                if (result != status::status_no_error)
-                {
-                    return status::status_param_unsupported;
-                }
+                return m_math_projection.rs_3d_array_projection_32f(psrc, pdst, npoints, camera_src, nullptr, nullptr, m_translation, nullptr, camera_dst);
             }
-            else
+            if (!m_is_color_fisheye)
             {
                 // if color image is not rectified, we should assume rotation and distorsion of color image
-                status result = m_math_projection.rs_3d_array_projection_32f((const float*)pos3d, (float*)pos_ij, npoints, nullptr, nullptr, m_rotation, m_translation, m_distorsion_color_coeffs, m_camera_color_params);
-                if (result != status::status_no_error)
-                {
-                    return status::status_param_unsupported;
-                }
+                return m_math_projection.rs_3d_array_projection_32f(psrc, pdst, npoints, camera_src, nullptr, m_rotation, m_translation, m_distorsion_color_coeffs, camera_dst);
             }
-            return status::status_no_error;
+            // the points are projected to the undistorted normalized fisheye image, then the fisheye distortion and camera are applied,
+            // the points on the camera plane are projected to (0, 0) and are kept invalid instead of being mapped to the principal point
+            float identity_camera[4] = { 1.f, 0.f, 1.f, 0.f };
+            status sts = m_math_projection.rs_3d_array_projection_32f(psrc, pdst, npoints, camera_src, nullptr, m_rotation, m_translation, nullptr, identity_camera);
+            sizeI32 points_size = { npoints, 1 };
+            m_math_projection.rs_fisheye_distortion_32f_c2ir(pdst, npoints * static_cast<int>(sizeof(pointF32)), points_size, nullptr, 0, true, m_fisheye_coeff, camera_dst);
+            return sts;
         }
 
 
@@ -273,24 +569,30 @@ namespace rs
             float inv_width = 1.f / (float)m_color_size.width;
             float inv_height = 1.f / (float)m_color_size.height;
             float cameraC[4] = { m_camera_color_params[0] * inv_width, m_camera_color_params[1] * inv_width, m_camera_color_params[2] * inv_height, m_camera_color_params[3] * inv_height };
-            if (m_is_color_rectified)
+            // if color image is not rectified, we should assume rotation and distorsion of the image
+            float* rotation = m_is_color_rectified ? nullptr : m_rotation;
+            float* distorsion = m_is_color_rectified || m_is_color_fisheye ? nullptr : m_distorsion_color_coeffs;
+            // the fisheye distortion is applied to the normalized undistorted coordinates after the projection
+            float identity_camera[4] = { 1.f, 0.f, 1.f, 0.f };
+            float* camera = m_is_color_fisheye ? identity_camera : cameraC;
+            std::atomic<bool> is_unsupported(false);
+            parallel_rows(depth_size.height, [&](int first_row, int rows_count)
             {
-                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)uvmap, dst_pitches,
-                        0, m_translation, 0, cameraC, (const projection_spec_32f*)m_projection_spec))
+                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr_rows((const unsigned short*)data, depth_size, info.pitch, (float*)uvmap, dst_pitches,
+                        first_row, rows_count, rotation, m_translation, distorsion, camera, (const projection_spec_32f*)m_projection_spec.get()))
                 {
-                    return status::status_feature_unsupported;
+                    is_unsupported = true;
+                    return;
                 }
-            }
-            else
-            {
-                // if color image is not rectified, we should assume rotation and distorsion of the image
-                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)uvmap, dst_pitches,
-                        m_rotation, m_translation, m_distorsion_color_coeffs, cameraC, (const projection_spec_32f*)m_projection_spec))
+                sizeI32 rows_size = { depth_size.width, rows_count };
+                if (m_is_color_fisheye)
                 {
-                    return status::status_feature_unsupported;
+                    m_math_projection.rs_fisheye_distortion_32f_c2ir((float*)((uint8_t*)uvmap + first_row * dst_pitches), dst_pitches, rows_size,
+                            (const unsigned short*)((const uint8_t*)data + first_row * info.pitch), info.pitch, true, m_fisheye_coeff, cameraC);
                 }
-            }
-            m_math_projection.rs_uvmap_filter_32f_c2ir((float*)uvmap, dst_pitches, depth_size, 0, 0, 0 );
+                m_math_projection.rs_uvmap_filter_32f_c2ir((float*)((uint8_t*)uvmap + first_row * dst_pitches), dst_pitches, rows_size, 0, 0, 0 );
+            });
+            if (is_unsupported) return status::status_feature_unsupported;
             return status::status_no_error;
         }
 
@@ -300,16 +602,28 @@ namespace rs
             if (!inv_uvmap) return status::status_handle_invalid;
             if (!depth) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
-            std::vector<pointF32> uvmap(depth->query_info().width * depth->query_info().height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
+            scratch_lease scratch(*this);
+            pointF32* uvmap = scratch.get(scratch_buffer::uvmap, depth->query_info().width * depth->query_info().height);
+            if (status::status_no_error > query_uvmap(depth, uvmap))
                 return status::status_data_unavailable;
             int src_pitches = depth->query_info().width * get_pixel_size(pixel_format::xyz32f) * 2;
             image_info info = depth->query_info();
             sizeI32 depth_size = { info.width, info.height };
             sizeI32 color_size = { m_color_size.width, m_color_size.height };
-            rect uvMapRoi = { 0, 0, info.width, info.height };
             pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
-            if(status::status_no_error != m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap.data(), src_pitches, depth_size, uvMapRoi, (float*)inv_uvmap, color_size.width * static_cast<int>(sizeof(pointF32)), color_size, 1, threshold))
+            pointF32* rows_range = scratch.get(scratch_buffer::uvmap_rows_range, depth_size.height);
+            query_uvmap_rows_range(uvmap, depth_size, rows_range);
+            // each thread inverts to its own color rows band, so the bands don't need to be merged,
+            // and scans only the uvmap rows which are mapped into its band
+            std::atomic<bool> is_failed(false);
+            parallel_rows(color_size.height, [&](int first_row, int rows_count)
+            {
+                rect inv_uvmap_roi = { 0, first_row, color_size.width, rows_count };
+                rect uvMapRoi = invertor_src_roi(rows_range, depth_size, color_size.height, first_row, rows_count);
+                if(status::status_no_error != m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap, src_pitches, depth_size, uvMapRoi, (float*)inv_uvmap, color_size.width * static_cast<int>(sizeof(pointF32)), color_size, inv_uvmap_roi, 1, threshold))
+                    is_failed = true;
+            });
+            if(is_failed)
                 return status::status_feature_unsupported;
             return status::status_no_error;
         }
@@ -324,8 +638,11 @@ namespace rs
             const void* data = depth->query_data();
             if (!data) return status::status_data_unavailable;
             sizeI32 depth_size = { info.width, info.height };
-            m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)vertices, depth_size.width * static_cast<int>(sizeof(point3dF32)),
-                    0, 0, 0, 0, (const projection_spec_32f*)m_projection_spec);
+            parallel_rows(depth_size.height, [&](int first_row, int rows_count)
+            {
+                m_math_projection.rs_projection_16u32f_c1cxr_rows((const unsigned short*)data, depth_size, info.pitch, (float*)vertices, depth_size.width * static_cast<int>(sizeof(point3dF32)),
+                        first_row, rows_count, 0, 0, 0, 0, (const projection_spec_32f*)m_projection_spec.get());
+            });
             return status::status_no_error;
         }
 
@@ -337,22 +654,9 @@ namespace rs
             if (!pos_uvz) return status::status_handle_invalid;
             if (!pos_ij) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
-            if (m_is_color_rectified)
+            if (project_to_color((const float*)pos_uvz, (float*)pos_ij, npoints, m_camera_depth_params, m_camera_color_params) != status::status_no_error)
             {
-                status result = m_math_projection.rs_3d_array_projection_32f((const float*)pos_uvz, (float*)pos_ij, npoints, m_camera_depth_params, nullptr, nullptr, m_translation, nullptr, m_camera_color_params);
-                if (result != status::status_no_error)
-                {
-                    return status::status_param_unsupported;
-                }
-            }
-            else
-            {
-                // if color image is not rectified, we should assume rotation and distorsion of the image
-                status result = m_math_projection.rs_3d_array_projection_32f((const float*)pos_uvz, (float*)pos_ij, npoints, m_camera_depth_params, nullptr, m_rotation, m_translation, m_distorsion_color_coeffs, m_camera_color_params);
-                if (result != status::status_no_error)
-                {
-                    return status::status_param_unsupported;
-                }
+                return status::status_param_unsupported;
             }
             return status::status_no_error;
         }
@@ -366,59 +670,13 @@ namespace rs
             if (!pos_uv) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
 
-            if (m_step_buffer.size() == 0)
-            {
-                const int32_t max_size = 25;
-                m_step_buffer.reserve(max_size);
-                const int niter = 2;
-                m_step_buffer.push_back({0, 0});
-                for(int i = 1; i <= niter; i++)
-                {
-                    m_step_buffer.push_back({0, i});
-                    m_step_buffer.push_back({-i, 0});
-                    m_step_buffer.push_back({i, 0});
-                    m_step_buffer.push_back({0, -i});
-                    for(int j = 1; j <= i - 1; j++)
-                    {
-                        m_step_buffer.push_back({-j, i});
-                        m_step_buffer.push_back({j, i});
-
-                        m_step_buffer.push_back({-i, j});
-                        m_step_buffer.push_back({i, j});
-
-                        m_step_buffer.push_back({-i, -j});
-                        m_step_buffer.push_back({i, -j});
-
-                        m_step_buffer.push_back({-j, -i});
-                        m_step_buffer.push_back({j, -i});
-                    }
-                    m_step_buffer.push_back({-i, i});
-                    m_step_buffer.push_back({i, i});
-                    m_step_buffer.push_back({-i, -i});
-                    m_step_buffer.push_back({i, -i});
-                }
-
-                m_sparse_invuvmap = new pointI32[m_color_size.width * m_color_size.height];
-            }
-
-            memset(m_sparse_invuvmap, -1, sizeof(pointI32)*m_color_size.width*m_color_size.height);
-
             image_info depth_info = depth->query_info();
-            std::vector<pointF32> uvmap(depth_info.width * depth_info.height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
+            std::shared_ptr<const color_to_depth_context> context;
+            if (status::status_no_error > get_color_to_depth_context(depth, context))
                 return status::status_data_unavailable;
+            const std::vector<pointF32> &uvmap = context->uvmap;
+            const pointI32 *sparse_invuvmap = context->sparse_invuvmap.data();
 
-            for(int u = 0; u < depth_info.width; u++)
-            {
-                for(int v = 0; v < depth_info.height; v++)
-                {
-                    int i = static_cast<int>(uvmap[u+v*depth_info.width].x*(float)m_color_size.width);
-                    int j = static_cast<int>(uvmap[u+v*depth_info.width].y*(float)m_color_size.height);
-                    if(i < 0) continue; if(j < 0) continue; // skip invalid pixel coordinates
-                    m_sparse_invuvmap[i+j*m_color_size.width].x = u;
-                    m_sparse_invuvmap[i+j*m_color_size.width].y = v;
-                }
-            }
             status sts = status::status_no_error;
             const int step_buffer_size = static_cast<int>(m_step_buffer.size());
             pointI32 index;
@@ -438,16 +696,16 @@ namespace rs
                     if (index.x >= m_color_size.width || index.y >= m_color_size.height) continue; // indexes out of range
                     if (index.x < 0 || index.y < 0) continue; // indexes out of range
                     const int index_with_step = index.x+index.y*m_color_size.width;
-                    if (m_sparse_invuvmap[index_with_step].x < 0) continue;
+                    if (sparse_invuvmap[index_with_step].x < 0) continue;
 
-                    float prod_x = tmp_pos_color.x - uvmap[m_sparse_invuvmap[index_with_step].x+m_sparse_invuvmap[index_with_step].y*depth_info.width].x;
-                    float prod_y = tmp_pos_color.y - uvmap[m_sparse_invuvmap[index_with_step].x+m_sparse_invuvmap[index_with_step].y*depth_info.width].y;
+                    float prod_x = tmp_pos_color.x - uvmap[sparse_invuvmap[index_with_step].x+sparse_invuvmap[index_with_step].y*depth_info.width].x;
+                    float prod_y = tmp_pos_color.y - uvmap[sparse_invuvmap[index_with_step].x+sparse_invuvmap[index_with_step].y*depth_info.width].y;
                     float r = static_cast<float>(fabs(prod_x) + fabs(prod_y));
                     if (r < min_dist)
                     {
                         min_dist = r;
-                        Ox = m_sparse_invuvmap[index_with_step].x;
-                        Oy = m_sparse_invuvmap[index_with_step].y;
+                        Ox = sparse_invuvmap[index_with_step].x;
+                        Oy = sparse_invuvmap[index_with_step].y;
                         if (m_step_buffer[j].x == 0 && m_step_buffer[j].y == 0) break;
                     }
                 }
@@ -459,6 +717,64 @@ namespace rs
         }
 
 
+        status ds4_projection::get_color_to_depth_context(image_interface *depth, std::shared_ptr<const color_to_depth_context> &context)
+        {
+            // the uvmap and the sparse inverse uvmap are built once per depth frame, following calls with the same frame only look up the points.
+            // an image without frame number and time stamp, as created from raw data, may be refilled in place, so it isn't cached.
+            const bool is_frame_identified = depth->query_frame_number() != 0 || depth->query_time_stamp() != 0;
+            const uint32_t contexts_count = m_color_to_depth_contexts_count;
+            if (is_frame_identified)
+            {
+                for (uint32_t i = 0; i < contexts_count; i++)
+                {
+                    context = std::atomic_load(&m_color_to_depth_contexts[i]);
+                    if (context && context->frame_number == depth->query_frame_number() &&
+                        context->time_stamp == depth->query_time_stamp() && context->data == depth->query_data())
+                    {
+                        return status::status_no_error;
+                    }
+                }
+            }
+
+            // threads which miss the cache at the same time build their own context, each new context replaces the oldest cached one
+            std::shared_ptr<color_to_depth_context> new_context = std::make_shared<color_to_depth_context>();
+            image_info depth_info = depth->query_info();
+            new_context->uvmap.resize(depth_info.width * depth_info.height);
+            status sts = query_uvmap(depth, new_context->uvmap.data());
+            if (status::status_no_error > sts)
+                return sts;
+
+            pointI32 invalid_pixel = { -1, -1 };
+            new_context->sparse_invuvmap.assign(m_color_size.width * m_color_size.height, invalid_pixel);
+            const pointF32 *uv = new_context->uvmap.data();
+            for(int v = 0; v < depth_info.height; v++)
+            {
+                for(int u = 0; u < depth_info.width; u++, uv++)
+                {
+                    int i = static_cast<int>(uv->x*(float)m_color_size.width);
+                    int j = static_cast<int>(uv->y*(float)m_color_size.height);
+                    if(i < 0 || j < 0) continue; // skip invalid pixel coordinates
+                    // the depth pixel with the highest column, and then the highest row, is kept, same as the column order scan
+                    pointI32 &pixel = new_context->sparse_invuvmap[i+j*m_color_size.width];
+                    if(pixel.x > u) continue;
+                    pixel.x = u;
+                    pixel.y = v;
+                }
+            }
+
+            new_context->frame_number = depth->query_frame_number();
+            new_context->time_stamp = depth->query_time_stamp();
+            new_context->data = depth->query_data();
+            context = new_context;
+            if (is_frame_identified && contexts_count > 0)
+            {
+                uint32_t slot = m_next_color_to_depth_context++ % contexts_count;
+                std::atomic_store(&m_color_to_depth_contexts[slot], context);
+            }
+            return status::status_no_error;
+        }
+
+
         // Create images
         image_interface *ds4_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color)
         {
@@ -471,19 +787,45 @@ namespace rs
             image_info color2depth_info = { depth_info.width, depth_info.height, color_info.format, pitch };
 
             uint8_t* color2depth_data = new uint8_t[color2depth_info.height * color2depth_info.pitch];
-            memset(color2depth_data, 0, color2depth_info.height * color2depth_info.pitch);
-            int32_t color2depth_step = color2depth_info.pitch;
-            uint8_t* ptr_color2depth_data = color2depth_data;
-
-            std::vector<pointF32> uvmap(depth_info.width * depth_info.height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
+            if (status::status_no_error > create_color_image_mapped_to_depth(depth, color, color2depth_info, color2depth_data))
             {
                 delete[] color2depth_data;
                 return nullptr;
             }
+
+            auto data_releaser = new rs::utils::self_releasing_array_data_releaser(color2depth_data);
+            
+            return image_interface::create_instance_from_raw_data(&color2depth_info,
+                                                                  {color2depth_data, data_releaser},
+                                                                  color->query_stream_type(),
+                                                                  image_interface::flag::any,
+                                                                  0,
+                                                                  0);
+        }
+
+
+        status ds4_projection::create_color_image_mapped_to_depth(image_interface *depth, image_interface *color,
+                                                                  const image_info &color2depth_info, uint8_t *color2depth_data)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!color) return status::status_handle_invalid;
+            if (!color2depth_data) return status::status_handle_invalid;
+
+            image_info depth_info = depth->query_info();
+            image_info color_info = color->query_info();
+            if (color2depth_info.width != depth_info.width || color2depth_info.height != depth_info.height ||
+                color2depth_info.format != color_info.format || color2depth_info.pitch < depth_info.width * get_pixel_size(color_info.format))
+                return status::status_param_unsupported;
+
+            memset(color2depth_data, 0, color2depth_info.height * color2depth_info.pitch);
+            int32_t color2depth_step = color2depth_info.pitch;
+
+            scratch_lease scratch(*this);
+            pointF32* uvmap = scratch.get(scratch_buffer::uvmap, depth_info.width * depth_info.height);
+            status sts = query_uvmap(depth, uvmap);
+            if (status::status_no_error > sts)
+                return sts;
             int32_t uvmap_step = depth_info.width * get_pixel_size(pixel_format::bgra8) * 2;
-            uint8_t* ptr_uvmap = (uint8_t*)uvmap.data();
-            pointF32* ptr_uvmap_32f;
 
             int32_t color_step = color_info.pitch;
             uint8_t* ptr_color = reinterpret_cast<uint8_t*>(const_cast<void*>(color->query_data()));
@@ -506,33 +848,31 @@ namespace rs
                     channels = 1;
             }
 
-            for(int i = 0; i < depth_info.height; i++)
+            parallel_rows(depth_info.height, [&](int first_row, int rows_count)
             {
-                for (int j = 0, xi = 0; j < depth_info.width; j++, xi+= channels)
+                uint8_t* ptr_uvmap = (uint8_t*)uvmap + first_row * uvmap_step;
+                uint8_t* ptr_color2depth_data = color2depth_data + first_row * color2depth_step;
+                pointF32* ptr_uvmap_32f;
+                for(int i = first_row; i < first_row + rows_count; i++)
                 {
-                    ptr_uvmap_32f = ((pointF32*)ptr_uvmap) + j;
-                    if(ptr_uvmap_32f->x >= 0.f && ptr_uvmap_32f->x < 1.f && ptr_uvmap_32f->y >= 0.f && ptr_uvmap_32f->y < 1.f)
+                    for (int j = 0, xi = 0; j < depth_info.width; j++, xi+= channels)
                     {
-                        uint8_t* ptr_color_tmp = &ptr_color[(int)(ptr_uvmap_32f->y * (float)color_info.height) * color_step
-                                                            + channels * (int)(ptr_uvmap_32f->x * (float)color_info.width)];
-                        for (int c = 0; c < channels; c++)
+                        ptr_uvmap_32f = ((pointF32*)ptr_uvmap) + j;
+                        if(ptr_uvmap_32f->x >= 0.f && ptr_uvmap_32f->x < 1.f && ptr_uvmap_32f->y >= 0.f && ptr_uvmap_32f->y < 1.f)
                         {
-                            ptr_color2depth_data[xi+c] = ptr_color_tmp[c];
+                            uint8_t* ptr_color_tmp = &ptr_color[(int)(ptr_uvmap_32f->y * (float)color_info.height) * color_step
+                                                                + channels * (int)(ptr_uvmap_32f->x * (float)color_info.width)];
+                            for (int c = 0; c < channels; c++)
+                            {
+                                ptr_color2depth_data[xi+c] = ptr_color_tmp[c];
+                            }
                         }
                     }
+                    ptr_uvmap += uvmap_step;
+                    ptr_color2depth_data += color2depth_step;
                 }
-                ptr_uvmap += uvmap_step;
-                ptr_color2depth_data += color2depth_step;
-            }
-
-            auto data_releaser = new rs::utils::self_releasing_array_data_releaser(color2depth_data);
-            
-            return image_interface::create_instance_from_raw_data(&color2depth_info,
-                                                                  {color2depth_data, data_releaser},
-                                                                  color->query_stream_type(),
-                                                                  image_interface::flag::any,
-                                                                  0,
-                                                                  0);
+            });
+            return status::status_no_error;
         }
 
 
@@ -541,46 +881,17 @@ namespace rs
             if (!depth) return nullptr;
             if (!color) return nullptr;
 
-            uint16_t default_depth_value = 0;
             image_info depth_info = depth->query_info();
             image_info color_info = color->query_info();
             int32_t pitch = color_info.width * get_pixel_size(pixel_format::z16);
             image_info depth2color_info = { color_info.width, color_info.height, depth_info.format, pitch };
 
             uint8_t* depth2color_data = new uint8_t[depth2color_info.height * depth2color_info.pitch];
-            memset(depth2color_data, 0, depth2color_info.height * depth2color_info.pitch);
-            uint16_t* depth_data = reinterpret_cast<uint16_t*>(const_cast<void*>(depth->query_data()));
-
-            std::vector<pointF32> uvmap(depth_info.width*depth_info.height);
-            if (status::status_no_error > query_uvmap(depth, uvmap.data()))
+            if (status::status_no_error > create_depth_image_mapped_to_color(depth, color, depth2color_info, depth2color_data))
             {
                 delete[] depth2color_data;
                 return nullptr;
             }
-            std::lock_guard<std::recursive_mutex> auto_lock(m_cs_buffer);
-            int32_t invuvmapPoints = static_cast<int32_t>(x64_ALIGNMENT(color_info.width * color_info.height * sizeof(pointF32)));
-            if(invuvmapPoints > m_buffer_size)
-            {
-                if(m_buffer) aligned_free(m_buffer);
-                m_buffer = 0;
-                m_buffer = (pointF32*)aligned_malloc(sizeof(pointF32) * invuvmapPoints);
-
-                if(!m_buffer)
-                {
-                    delete[] depth2color_data;
-                    return 0;
-                }
-                m_buffer_size = invuvmapPoints;
-            }
-            sizeI32 depth_size = { depth_info.width, depth_info.height };
-            sizeI32 color_size = { color_info.width, color_info.height };
-            rect uvmap_roi = { 0, 0, depth_info.width, depth_info.height };
-            pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
-            m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap.data(), depth_info.width * get_pixel_size(pixel_format::xyz32f) * 2,
-                    depth_size, uvmap_roi, (float*)m_buffer, color_info.width * static_cast<int>(sizeof(pointF32)), color_size, 0 , threshold);
-            m_math_projection.rs_remap_16u_c1r((unsigned short*)depth_data, depth_size, depth_info.pitch,
-                                               (float*)m_buffer, color_info.width * static_cast<int>(sizeof(pointF32)), (uint16_t*)depth2color_data,
-                                               color_size, depth2color_info.pitch, 0, default_depth_value);
 
             auto data_releaser = new rs::utils::self_releasing_array_data_releaser(depth2color_data);
 
@@ -593,7 +904,400 @@ namespace rs
         }
 
 
+        status ds4_projection::create_depth_image_mapped_to_color(image_interface *depth, image_interface *color,
+                                                                  const image_info &depth2color_info, uint8_t *depth2color_data)
+        {
+            if (!depth) return status::status_handle_invalid;
+            if (!color) return status::status_handle_invalid;
+            if (!depth2color_data) return status::status_handle_invalid;
+
+            uint16_t default_depth_value = 0;
+            image_info depth_info = depth->query_info();
+            image_info color_info = color->query_info();
+            if (depth2color_info.width != color_info.width || depth2color_info.height != color_info.height ||
+                depth2color_info.format != depth_info.format || depth2color_info.pitch < color_info.width * get_pixel_size(pixel_format::z16))
+                return status::status_param_unsupported;
+
+            memset(depth2color_data, 0, depth2color_info.height * depth2color_info.pitch);
+            uint16_t* depth_data = reinterpret_cast<uint16_t*>(const_cast<void*>(depth->query_data()));
+
+            scratch_lease scratch(*this);
+            pointF32* uvmap = scratch.get(scratch_buffer::uvmap, depth_info.width * depth_info.height);
+            status sts = query_uvmap(depth, uvmap);
+            if (status::status_no_error > sts)
+                return sts;
+            pointF32* rows_range = scratch.get(scratch_buffer::uvmap_rows_range, depth_info.height);
+            depth_to_color_registration registration = m_depth_to_color_registration;
+            if (registration != depth_to_color_registration::inverse_uvmap)
+            {
+                splat_depth_to_color(depth_info, depth_data, uvmap, depth2color_info, depth2color_data,
+                                     registration == depth_to_color_registration::splat_2x2 ? 2 : 1, rows_range);
+                return status::status_no_error;
+            }
+
+            pointF32* inv_uvmap = scratch.get(scratch_buffer::inv_uvmap, color_info.width * color_info.height);
+            sizeI32 depth_size = { depth_info.width, depth_info.height };
+            sizeI32 color_size = { color_info.width, color_info.height };
+            pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
+            int32_t inv_uvmap_step = color_info.width * static_cast<int>(sizeof(pointF32));
+            query_uvmap_rows_range(uvmap, depth_size, rows_range);
+            // each thread inverts and remaps its own color rows band, scanning only the uvmap rows which are mapped into its band
+            parallel_rows(color_size.height, [&](int first_row, int rows_count)
+            {
+                rect inv_uvmap_roi = { 0, first_row, color_size.width, rows_count };
+                rect uvmap_roi = invertor_src_roi(rows_range, depth_size, color_size.height, first_row, rows_count);
+                sizeI32 rows_size = { color_size.width, rows_count };
+                m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap, depth_info.width * get_pixel_size(pixel_format::xyz32f) * 2,
+                        depth_size, uvmap_roi, (float*)inv_uvmap, inv_uvmap_step, color_size, inv_uvmap_roi, 0 , threshold);
+                m_math_projection.rs_remap_16u_c1r((unsigned short*)depth_data, depth_size, depth_info.pitch,
+                                                   (float*)(inv_uvmap + first_row * color_size.width), inv_uvmap_step,
+                                                   (uint16_t*)(depth2color_data + first_row * depth2color_info.pitch),
+                                                   rows_size, depth2color_info.pitch, 0, default_depth_value);
+            });
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::query_point_cloud(image_interface *depth, image_interface *color, const point_cloud_params &params, int32_t max_points,
+                                                 point3dF32 *vertices, pointF32 *uvmap, uint8_t *colors, int32_t *npoints)
+        {
+            if (!depth || !vertices || !npoints) return status::status_handle_invalid;
+            if (colors && !color) return status::status_handle_invalid;
+            if (params.decimation <= 0 || params.min_depth < 0 || (params.max_depth > 0 && params.max_depth < params.min_depth)) return status::status_param_unsupported;
+            if (!(m_initialize_status & initialize_status::depth_initialized)) return status::status_data_unavailable;
+            bool is_mapped = uvmap || colors;
+            if (is_mapped && m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            *npoints = 0;
+
+            image_info depth_info = depth->query_info();
+            const uint8_t* depth_data = static_cast<const uint8_t*>(depth->query_data());
+            if (!depth_data) return status::status_data_unavailable;
+            if (depth_info.width != m_depth_size.width || depth_info.height != m_depth_size.height) return status::status_feature_unsupported;
+            const int32_t decimated_width = (depth_info.width + params.decimation - 1) / params.decimation;
+            const int32_t decimated_height = (depth_info.height + params.decimation - 1) / params.decimation;
+            if (max_points < decimated_width * decimated_height) return status::status_param_unsupported;
+
+            image_info color_info = {};
+            const uint8_t* color_data = nullptr;
+            int32_t channels = 0;
+            if (colors)
+            {
+                color_info = color->query_info();
+                color_data = static_cast<const uint8_t*>(color->query_data());
+                channels = get_pixel_size(color_info.format);
+                if (!color_data || channels == 0) return status::status_data_unavailable;
+            }
+
+            // same as query_uvmap, the color camera is normalized to the color image size
+            float inv_width = 1.f / (float)m_color_size.width;
+            float inv_height = 1.f / (float)m_color_size.height;
+            float cameraC[4] = { m_camera_color_params[0] * inv_width, m_camera_color_params[1] * inv_width, m_camera_color_params[2] * inv_height, m_camera_color_params[3] * inv_height };
+            const float max_depth = params.max_depth > 0 ? params.max_depth : std::numeric_limits<float>::max();
+            // same as the depth projection spec, the depth pixels are deprojected in double precision
+            const double invFx = (double)(1. / m_camera_depth_params[0]);
+            const double invFy = (double)(1. / m_camera_depth_params[2]);
+
+            // the valid points of a row are gathered to chunks, each chunk is mapped to the color image with a single array projection
+            const int32_t chunk_size = 64;
+            point3dF32 chunk_vertices[chunk_size];
+            pointF32 chunk_uv[chunk_size];
+            int32_t chunk_index[chunk_size];
+            const pointF32 invalid_uv = { -1.f, -1.f };
+            const point3dF32 invalid_vertex = { 0.f, 0.f, 0.f };
+            int32_t count = 0;
+
+            auto flush_chunk = [&](int32_t chunk_points)
+            {
+                if (is_mapped)
+                    project_to_color((const float*)chunk_vertices, (float*)chunk_uv, chunk_points, nullptr, cameraC);
+                for (int32_t n = 0; n < chunk_points; n++)
+                {
+                    int32_t index = chunk_index[n];
+                    vertices[index] = chunk_vertices[n];
+                    if (!is_mapped) continue;
+                    pointF32 uv = chunk_uv[n];
+                    bool is_in_color = uv.x >= 0.f && uv.x < 1.f && uv.y >= 0.f && uv.y < 1.f;
+                    if (uvmap) uvmap[index] = is_in_color ? uv : invalid_uv;
+                    if (!colors) continue;
+                    uint8_t* dst_color = colors + index * channels;
+                    if (is_in_color)
+                    {
+                        const uint8_t* src_color = color_data + (int)(uv.y * (float)color_info.height) * color_info.pitch + channels * (int)(uv.x * (float)color_info.width);
+                        memcpy(dst_color, src_color, channels);
+                    }
+                    else
+                    {
+                        memset(dst_color, 0, channels);
+                    }
+                }
+            };
+
+            for (int32_t y = 0; y < depth_info.height; y += params.decimation)
+            {
+                const uint16_t* depth_row = reinterpret_cast<const uint16_t*>(depth_data + y * depth_info.pitch);
+                const float v = static_cast<float>(((double)y - m_camera_depth_params[3]) * invFy);
+                int32_t chunk_points = 0;
+                for (int32_t x = 0; x < depth_info.width; x += params.decimation)
+                {
+                    float z = static_cast<float>(depth_row[x]);
+                    if (z == 0 || z < params.min_depth || z > max_depth)
+                    {
+                        if (params.compact) continue;
+                        vertices[count] = invalid_vertex;
+                        if (uvmap) uvmap[count] = invalid_uv;
+                        if (colors) memset(colors + count * channels, 0, channels);
+                        count++;
+                        continue;
+                    }
+                    const float u = static_cast<float>(((double)x - m_camera_depth_params[1]) * invFx);
+                    chunk_vertices[chunk_points] = { u * z, v * z, z };
+                    chunk_index[chunk_points] = count++;
+                    if (++chunk_points == chunk_size)
+                    {
+                        flush_chunk(chunk_points);
+                        chunk_points = 0;
+                    }
+                }
+                if (chunk_points > 0)
+                    flush_chunk(chunk_points);
+            }
+            *npoints = count;
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::set_threads_count(uint32_t threads_count)
+        {
+            m_threads_count = threads_count > 0 ? threads_count : std::max(1u, std::thread::hardware_concurrency());
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::set_depth_to_color_registration(depth_to_color_registration registration)
+        {
+            switch (registration)
+            {
+                case depth_to_color_registration::inverse_uvmap:
+                case depth_to_color_registration::splat:
+                case depth_to_color_registration::splat_2x2:
+                    m_depth_to_color_registration = registration;
+                    return status::status_no_error;
+                default:
+                    return status::status_param_unsupported;
+            }
+        }
+
+
+        status ds4_projection::set_color_to_depth_cache_size(uint32_t frames_count)
+        {
+            if (frames_count > MAX_COLOR_TO_DEPTH_CONTEXTS) return status::status_param_unsupported;
+            m_color_to_depth_contexts_count = frames_count;
+            // the mappings out of the new cache size are released, the ones in it are replaced by the following frames
+            for (uint32_t i = frames_count; i < MAX_COLOR_TO_DEPTH_CONTEXTS; i++)
+                std::atomic_store(&m_color_to_depth_contexts[i], std::shared_ptr<const color_to_depth_context>());
+            return status::status_no_error;
+        }
+
+
+        status ds4_projection::undistort_color_image(image_interface *color, const image_info &undistorted_info, uint8_t *undistorted_data)
+        {
+            if (!color) return status::status_handle_invalid;
+            if (!undistorted_data) return status::status_handle_invalid;
+            if (!(m_initialize_status & initialize_status::color_initialized)) return status::status_data_unavailable;
+
+            image_info color_info = color->query_info();
+            const uint8_t* color_data = static_cast<const uint8_t*>(color->query_data());
+            if (!color_data) return status::status_data_unavailable;
+            switch (color_info.format)
+            {
+                case pixel_format::rgb8:
+                case pixel_format::bgr8:
+                case pixel_format::rgba8:
+                case pixel_format::bgra8:
+                case pixel_format::y8:
+                case pixel_format::raw8:
+                    break;
+                default:
+                    return status::status_feature_unsupported;
+            }
+            if (color_info.width != m_color_size.width || color_info.height != m_color_size.height) return status::status_feature_unsupported;
+            const int32_t channels = get_pixel_size(color_info.format);
+            if (undistorted_info.width != color_info.width || undistorted_info.height != color_info.height ||
+                undistorted_info.format != color_info.format || undistorted_info.pitch < color_info.width * channels)
+                return status::status_param_unsupported;
+
+            if (m_is_color_rectified)
+            {
+                // the rectified color image has no distortion
+                for (int32_t y = 0; y < color_info.height; y++)
+                    memcpy(undistorted_data + y * undistorted_info.pitch, color_data + y * color_info.pitch, color_info.width * channels);
+                return status::status_no_error;
+            }
+
+            std::shared_ptr<const std::vector<pointF32>> undistortion_map = get_color_undistortion_map();
+            sizeI32 color_size = { color_info.width, color_info.height };
+            int32_t map_step = color_info.width * static_cast<int>(sizeof(pointF32));
+            parallel_rows(color_info.height, [&](int first_row, int rows_count)
+            {
+                sizeI32 rows_size = { color_info.width, rows_count };
+                m_math_projection.rs_remap_8u_cnr(color_data, color_size, color_info.pitch, channels,
+                                                  (const float*)(undistortion_map->data() + first_row * color_info.width), map_step,
+                                                  undistorted_data + first_row * undistorted_info.pitch, rows_size, undistorted_info.pitch, 1, 0);
+            });
+            return status::status_no_error;
+        }
+
+
+        std::shared_ptr<const std::vector<pointF32>> ds4_projection::get_color_undistortion_map()
+        {
+            // the map is built by the first call and shared by all the following calls, threads which miss it at the same time build their own map
+            std::shared_ptr<const std::vector<pointF32>> undistortion_map = std::atomic_load(&m_color_undistortion_map);
+            if (undistortion_map)
+                return undistortion_map;
+
+            // the undistorted image has the color camera intrinsics without the distortion,
+            // each of its pixels is located in the color image by distorting its normalized coordinates
+            const int32_t width = m_color_size.width;
+            std::shared_ptr<std::vector<pointF32>> new_map = std::make_shared<std::vector<pointF32>>(width * m_color_size.height);
+            const float inv_fx = 1.f / m_camera_color_params[0];
+            const float inv_fy = 1.f / m_camera_color_params[2];
+            parallel_rows(m_color_size.height, [&](int first_row, int rows_count)
+            {
+                std::vector<point3dF32> row_points(m_is_color_fisheye ? 0 : width);
+                for (int y = first_row; y < first_row + rows_count; y++)
+                {
+                    pointF32* row = new_map->data() + y * width;
+                    const float v = ((float)y - m_camera_color_params[3]) * inv_fy;
+                    if (m_is_color_fisheye)
+                    {
+                        for (int x = 0; x < width; x++)
+                            row[x] = { ((float)x - m_camera_color_params[1]) * inv_fx, v };
+                        sizeI32 row_size = { width, 1 };
+                        m_math_projection.rs_fisheye_distortion_32f_c2ir((float*)row, width * static_cast<int>(sizeof(pointF32)), row_size, nullptr, 0, false,
+                                                                         m_fisheye_coeff, m_camera_color_params);
+                    }
+                    else
+                    {
+                        for (int x = 0; x < width; x++)
+                            row_points[x] = { ((float)x - m_camera_color_params[1]) * inv_fx, v, 1.f };
+                        m_math_projection.rs_3d_array_projection_32f((const float*)row_points.data(), (float*)row, width, nullptr, nullptr, nullptr, nullptr,
+                                                                     m_distorsion_color_coeffs, m_camera_color_params);
+                    }
+                }
+            });
+
+            undistortion_map = new_map;
+            std::atomic_store(&m_color_undistortion_map, undistortion_map);
+            return undistortion_map;
+        }
+
+
         // Helper Functions
+        void ds4_projection::splat_depth_to_color(const image_info &depth_info, const uint16_t *depth_data, const pointF32 *uvmap,
+                                                  const image_info &depth2color_info, uint8_t *depth2color_data, int32_t splat_size, pointF32 *rows_range)
+        {
+            const float color_width = (float)depth2color_info.width;
+            const float color_height = (float)depth2color_info.height;
+            sizeI32 depth_size = { depth_info.width, depth_info.height };
+            query_uvmap_rows_range(uvmap, depth_size, rows_range);
+            // each thread owns a color rows band, and writes only the depth pixels which are mapped into its band.
+            // the depth rows which aren't mapped into the band are skipped by their color rows range.
+            // the destination is zero initialized, so a zero pixel is empty and any depth replaces it.
+            parallel_rows(depth2color_info.height, [&](int first_row, int rows_count)
+            {
+                const int last_row = first_row + rows_count;
+                for (int y = 0; y < depth_info.height; y++)
+                {
+                    if (rows_range[y].x > rows_range[y].y ||
+                        static_cast<int>(rows_range[y].x * color_height) >= last_row ||
+                        static_cast<int>(rows_range[y].y * color_height) + splat_size <= first_row)
+                        continue;
+                    const uint16_t *depth_row = reinterpret_cast<const uint16_t*>(reinterpret_cast<const uint8_t*>(depth_data) + y * depth_info.pitch);
+                    const pointF32 *uvmap_row = uvmap + y * depth_info.width;
+                    for (int x = 0; x < depth_info.width; x++)
+                    {
+                        const uint16_t z = depth_row[x];
+                        if (z == 0 || uvmap_row[x].x < 0.f) continue;
+                        const int i = static_cast<int>(uvmap_row[x].x * color_width);
+                        const int j = static_cast<int>(uvmap_row[x].y * color_height);
+                        const int j_end = std::min(j + splat_size, last_row);
+                        const int i_end = std::min(i + splat_size, depth2color_info.width);
+                        for (int jj = std::max(j, first_row); jj < j_end; jj++)
+                        {
+                            uint16_t *dst = reinterpret_cast<uint16_t*>(depth2color_data + jj * depth2color_info.pitch);
+                            for (int ii = i; ii < i_end; ii++)
+                            {
+                                if (dst[ii] == 0 || z < dst[ii])
+                                    dst[ii] = z;
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        ds4_projection::scratch_lease::scratch_lease(ds4_projection &owner) : m_owner(owner)
+        {
+            std::lock_guard<std::mutex> guard(owner.m_scratch_mutex);
+            if (owner.m_free_scratch_sets.empty())
+            {
+                m_set.reset(new scratch_set());
+                return;
+            }
+            m_set = std::move(owner.m_free_scratch_sets.back());
+            owner.m_free_scratch_sets.pop_back();
+        }
+
+        ds4_projection::scratch_lease::~scratch_lease()
+        {
+            std::lock_guard<std::mutex> guard(m_owner.m_scratch_mutex);
+            m_owner.m_free_scratch_sets.push_back(std::move(m_set));
+        }
+
+        pointF32* ds4_projection::scratch_lease::get(scratch_buffer buffer, int32_t size)
+        {
+            std::vector<pointF32> &scratch = m_set->buffers[static_cast<int>(buffer)];
+            if (scratch.size() < static_cast<size_t>(size))
+                scratch.resize(static_cast<size_t>(size));
+            return scratch.data();
+        }
+
+        void ds4_projection::parallel_rows(int rows, const std::function<void(int first_row, int rows_count)> &process_rows)
+        {
+            int threads_count = std::min(static_cast<int>(m_threads_count), rows);
+            if (threads_count <= 1)
+            {
+                process_rows(0, rows);
+                return;
+            }
+
+            m_row_workers->run(threads_count, [&](int band)
+            {
+                int first_row = rows * band / threads_count;
+                int last_row = rows * (band + 1) / threads_count;
+                process_rows(first_row, last_row - first_row);
+            });
+        }
+
+        void ds4_projection::query_uvmap_rows_range(const pointF32 *uvmap, sizeI32 uvmap_size, pointF32 *rows_range)
+        {
+            parallel_rows(uvmap_size.height, [&](int first_row, int rows_count)
+            {
+                for (int y = first_row; y < first_row + rows_count; y++)
+                {
+                    pointF32 range = { std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest() };
+                    const pointF32 *uvmap_row = uvmap + y * uvmap_size.width;
+                    for (int x = 0; x < uvmap_size.width; x++)
+                    {
+                        if (uvmap_row[x].x < 0.f) continue;
+                        range.x = std::min(range.x, uvmap_row[x].y);
+                        range.y = std::max(range.y, uvmap_row[x].y);
+                    }
+                    rows_range[y] = range;
+                }
+            });
+        }
+
         int ds4_projection::distorsion_ds_lms(float* Kc, float* invdistc, float* distc)
         {
             double dst[5];
@@ -836,7 +1540,9 @@ namespace rs
                 calib.color_height = (float)colorIntrinsics->height;
                 calib.depth_width = (float)depthIntrinsics->width;
                 calib.depth_height = (float)depthIntrinsics->height;
-                calib.is_color_rectified = 1; // for case of request for the RS_STREAM_COLOR
+                // the fisheye camera isn't rectified to the depth camera, its rotation and f-theta distortion are applied
+                bool is_color_fisheye = colorIntrinsics->model == distortion_type::distortion_ftheta;
+                calib.is_color_rectified = is_color_fisheye ? 0 : 1; // for case of request for the RS_STREAM_COLOR
                 calib.is_mirrored = 0;
                 calib.reserved = 0;
                 calib.color_calib = convert_intrinsics(colorIntrinsics);
@@ -848,6 +1554,15 @@ namespace rs
                 calib.depth_transform.translation[0] *= 1000;
                 calib.depth_transform.translation[1] *= 1000;
                 calib.depth_transform.translation[2] *= 1000;
+                if (is_color_fisheye)
+                {
+                    // the extrinsics rotation is column major, the projection rotation is row major
+                    for (int row = 0; row < 3; row++)
+                        for (int column = 0; column < 3; column++)
+                            calib.depth_transform.rotation[row][column] = extrinsics_->rotation[column * 3 + row];
+                    proj->init_from_float_array(&calib, colorIntrinsics->coeffs[0]);
+                    return proj;
+                }
                 proj->init_from_float_array(&calib);
                 return proj;
             }
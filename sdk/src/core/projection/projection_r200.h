@@ -2,8 +2,11 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
+#include <functional>
 
 #include "rs/core/projection_interface.h"
 #include "rs/utils/ref_count_base.h"
@@ -66,6 +69,8 @@ namespace rs
             virtual void reset();
 
             status init_from_float_array(r200_projection_float_array *data);
+            // the color camera is a fisheye camera of the f-theta distortion model, the color calibration distortion coefficients are ignored
+            status init_from_float_array(r200_projection_float_array *data, float fisheye_coeff);
 
             /* projection */
             virtual status project_depth_to_camera(int32_t npoints, point3dF32 *pos_uvz, point3dF32 *pos3d);
@@ -79,18 +84,72 @@ namespace rs
             virtual status query_vertices(image_interface *depth, point3dF32 *vertices);
             virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color);
             virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color);
+            virtual status create_color_image_mapped_to_depth(image_interface *depth, image_interface *color,
+                                                              const image_info &color2depth_info, uint8_t *color2depth_data);
+            virtual status create_depth_image_mapped_to_color(image_interface *depth, image_interface *color,
+                                                              const image_info &depth2color_info, uint8_t *depth2color_data);
+            virtual status query_point_cloud(image_interface *depth, image_interface *color, const point_cloud_params &params, int32_t max_points,
+                                             point3dF32 *vertices, pointF32 *uvmap, uint8_t *colors, int32_t *npoints);
+            virtual status set_threads_count(uint32_t threads_count);
+            virtual status set_depth_to_color_registration(depth_to_color_registration registration);
+            virtual status set_color_to_depth_cache_size(uint32_t frames_count);
+            virtual status undistort_color_image(image_interface *color, const image_info &undistorted_info, uint8_t *undistorted_data);
+
+            // the projection spec buffer, used by the tests to check that the instances of the same calibration share it
+            const uint8_t* query_projection_spec() const { return m_projection_spec.get(); }
 
         private:
             ds4_projection(const ds4_projection&) = delete;
             ds4_projection& operator=(const ds4_projection&) = delete;
 
+            status load_float_array(r200_projection_float_array *data);
             status init(bool isMirrored);
+            // projects camera points, or depth pixels if camera_src is set, to the color camera model
+            status project_to_color(const float *psrc, float *pdst, int32_t npoints, float *camera_src, float *camera_dst);
+            // gets the undistorted color image pixels locations in the color image, built by the first call
+            std::shared_ptr<const std::vector<pointF32>> get_color_undistortion_map();
             int distorsion_ds_lms(float* Kc, float* invdistc, float* distc);
             int projection_ds_lms12(float* r, float* t, float* ir, float* it);
+            // splits the rows between the calling thread and the instance worker threads, each call gets a contiguous non empty rows range
+            void parallel_rows(int rows, const std::function<void(int first_row, int rows_count)> &process_rows);
+            class row_workers;
+            // scratch buffers of the full image queries, owned by the instance. each query takes a set of buffers from the free sets
+            // and returns it when it is done, so concurrent queries use separate sets and repeated queries don't allocate
+            enum class scratch_buffer { uvmap, inv_uvmap, uvmap_rows_range, count };
+            struct scratch_set
+            {
+                std::vector<pointF32> buffers[static_cast<int>(scratch_buffer::count)];
+            };
+            class scratch_lease
+            {
+            public:
+                scratch_lease(ds4_projection &owner);
+                ~scratch_lease();
+                // the buffer keeps its largest size, its content is undefined
+                pointF32* get(scratch_buffer buffer, int32_t size);
+            private:
+                scratch_lease(const scratch_lease&) = delete;
+                scratch_lease& operator=(const scratch_lease&) = delete;
+                ds4_projection &m_owner;
+                std::unique_ptr<scratch_set> m_set;
+            };
+            // gets the lowest and highest color y of the valid pixels of each uvmap row, as the x and y of the row point.
+            // a row without valid pixels gets an x above its y.
+            void query_uvmap_rows_range(const pointF32 *uvmap, sizeI32 uvmap_size, pointF32 *rows_range);
+            // writes each depth pixel to the color pixels it is mapped to, keeping the nearest depth of each color pixel.
+            // rows_range is a scratch buffer of the depth image height
+            void splat_depth_to_color(const image_info &depth_info, const uint16_t *depth_data, const pointF32 *uvmap,
+                                      const image_info &depth2color_info, uint8_t *depth2color_data, int32_t splat_size, pointF32 *rows_range);
+            struct color_to_depth_context;
+            // gets the color to depth mapping of the depth frame, the mappings of the last few frames are shared by all the calling threads
+            status get_color_to_depth_context(image_interface *depth, std::shared_ptr<const color_to_depth_context> &context);
 
             math_projection m_math_projection;
 
             bool              m_is_platform_camera_projection;
+            std::atomic<uint32_t> m_threads_count;
+            std::unique_ptr<row_workers> m_row_workers; // parallel_rows threads, started on demand and kept until the instance is released
+            std::atomic<depth_to_color_registration> m_depth_to_color_registration;
             initialize_status m_initialize_status;
 
             // below is minimum set of parameters for projection initialization
@@ -120,14 +179,34 @@ namespace rs
             float m_invrot_color[9];     // Rotation matrix from Color to Depth camera
             float m_invtrans_color[3];   // Translation vector from Color to Depth camera
 
-            // internal buffers
-            uint8_t               *m_projection_spec; // Projection spec buffer used in QueryUVMap and QueryVertices
-            int                   m_projection_spec_size;// Projection spec buffer size
-            pointF32              *m_buffer;         // Projection internal buffer
-            int32_t               m_buffer_size;     // Projection internal buffer size
-            std::recursive_mutex  m_cs_buffer;        // Projection internal buffer protection mutex
-            std::vector<pointI32> m_step_buffer;
-            pointI32              *m_sparse_invuvmap;
+            // Used if the color camera is a fisheye camera, the color image isn't rectified and has no brown distortion
+            bool  m_is_color_fisheye;
+            float m_fisheye_coeff;       // The f-theta model field of view coefficient
+
+            // internal buffers, read only after initialization. the queries take their scratch buffers from the free scratch sets,
+            // so a single instance can be used by many threads at once.
+            std::shared_ptr<const uint8_t> m_projection_spec; // Projection spec buffer used in QueryUVMap and QueryVertices, shared by the instances of the same calibration
+            const std::vector<pointI32> m_step_buffer; // map_color_to_depth search neighbourhood, nearest steps first
+            std::mutex m_scratch_mutex;
+            std::vector<std::unique_ptr<scratch_set>> m_free_scratch_sets; // the scratch sets which aren't used by a query, guarded by m_scratch_mutex
+
+            // map_color_to_depth mappings of the last depth frames, reused by following calls with the same frame.
+            // more than one mapping is kept only if set_color_to_depth_cache_size asks for it, so threads which map different frames at once
+            // don't evict each other's mapping.
+            // a context is never modified once it is published, a new frame publishes a new context.
+            struct color_to_depth_context
+            {
+                uint64_t              frame_number;
+                double                time_stamp;
+                const void            *data;
+                std::vector<pointF32> uvmap;
+                std::vector<pointI32> sparse_invuvmap; // the depth pixel mapped to each color pixel, -1 if none
+            };
+            static const uint32_t MAX_COLOR_TO_DEPTH_CONTEXTS = 4;
+            std::shared_ptr<const color_to_depth_context> m_color_to_depth_contexts[MAX_COLOR_TO_DEPTH_CONTEXTS]; // accessed with std::atomic_load and std::atomic_store only
+            std::atomic<uint32_t> m_color_to_depth_contexts_count; // the number of used contexts slots, 1 by default
+            std::atomic<uint32_t> m_next_color_to_depth_context; // the cached context replaced by the next new context, the oldest one
+            std::shared_ptr<const std::vector<pointF32>> m_color_undistortion_map; // accessed with std::atomic_load and std::atomic_store only
         };
 
     }
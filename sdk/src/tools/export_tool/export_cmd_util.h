@@ -0,0 +1,87 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <thread>
+#include "cmd_base.h"
+
+/**  @brief The export_cmd_util class
+ *
+ * Command line utility with options suitable for export tool usage.
+ */
+class export_cmd_util : public rs::utils::cmd_base
+{
+public:
+    /** @brief export_cmd_util
+     *
+     * Constructor. Sets the relevant command line options.
+     */
+    export_cmd_util()
+    {
+        add_option("-h --h -help --help -?", "show help");
+
+        add_single_arg_option("-pb -playback", "set the recording file path");
+        add_single_arg_option("-o -output", "set the output directory, created if it doesn't exist", "", ".");
+        add_single_arg_option("-fmt -format", "set the output format - raw binary frames, png images or ply point clouds of the depth stream", "raw png ply", "png");
+
+        add_option("-d", "export depth stream");
+        add_option("-c", "export color stream");
+        add_option("-i", "export infrared stream");
+        add_option("-i2", "export infrared2 stream");
+        add_option("-f", "export fisheye stream");
+
+        add_multi_args_option_safe("-range", "set the range of exported frames indices - [<first>-<last>]", 2, '-');
+        add_single_arg_option("-t -threads", "set the number of worker threads, 0 uses all available cores", "", "0");
+
+        set_usage_example("-pb recording.rssdk -d -c -fmt png -o frames -t 8\n\n"
+                          "The following command will export the depth and color\n"
+                          "streams of recording.rssdk to png images in the frames\n"
+                          "directory, using 8 worker threads.\n"
+                          "All recorded streams are exported if no stream is selected.\n"
+                          "Each worker thread reads the file with its own frame reader.\n");
+    }
+
+    std::string get_file_path()
+    {
+        rs::utils::cmd_option opt;
+        return get_cmd_option("-pb -playback", opt) ? opt.m_option_args_values[0] : "";
+    }
+
+    std::string get_output_directory()
+    {
+        rs::utils::cmd_option opt;
+        return get_cmd_option("-o -output", opt) ? opt.m_option_args_values[0] : opt.m_default_value;
+    }
+
+    std::string get_format()
+    {
+        rs::utils::cmd_option opt;
+        return get_cmd_option("-fmt -format", opt) ? opt.m_option_args_values[0] : opt.m_default_value;
+    }
+
+    bool is_stream_selected(std::string tag)
+    {
+        rs::utils::cmd_option opt;
+        return get_cmd_option(tag, opt);
+    }
+
+    bool get_range(uint32_t & first, uint32_t & last)
+    {
+        rs::utils::cmd_option opt;
+        if(!get_cmd_option("-range", opt))
+            return false;
+        first = static_cast<uint32_t>(std::stoul(opt.m_option_args_values[0]));
+        last = static_cast<uint32_t>(std::stoul(opt.m_option_args_values[1]));
+        return true;
+    }
+
+    unsigned int get_threads_count()
+    {
+        rs::utils::cmd_option opt;
+        auto threads = std::stoul(get_cmd_option("-t -threads", opt) ? opt.m_option_args_values[0] : opt.m_default_value);
+        if(threads == 0)
+            threads = std::thread::hardware_concurrency();
+        return threads > 0 ? static_cast<unsigned int>(threads) : 1;
+    }
+};
@@ -0,0 +1,269 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/* realsense sdk */
+#include "rs/playback/playback_context.h"
+#include "rs/playback/playback_device.h"
+#include "rs/playback/frame_reader_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "export_cmd_util.h"
+#include "file_writers.h"
+
+/* librealsense */
+#include "librealsense/rs.hpp"
+
+/* standard library */
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <map>
+#include <limits>
+#include <algorithm>
+
+#ifdef WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace rs::core;
+using namespace rs::utils;
+
+/** @brief Range of frames of a single stream, exported by a single worker thread */
+struct export_job
+{
+    rs::stream  stream;
+    uint32_t    first;
+    uint32_t    end;    /**< one past the last exported frame index */
+};
+
+/** @brief Export configuration, shared by all worker threads */
+struct export_settings
+{
+    std::string     output_directory;
+    std::string     format;
+    rs::intrinsics  depth_intrinsics;
+    float           depth_scale;
+};
+
+/** @brief stream_type_to_string
+ *
+ * Get the stream name used in the exported files names.
+ * @param[in] stream    Stream type.
+ * @return: std::string Stream name.
+ */
+std::string stream_type_to_string(rs::stream stream);
+
+/** @brief create_jobs
+ *
+ * Split the exported frames range of each stream to contiguous sub ranges, one per worker thread,
+ * so each worker reads a contiguous part of the file.
+ * @param[in] streams_ranges    Exported frames range of each stream - [first, end).
+ * @param[in] threads_count     Number of worker threads.
+ * @return: std::vector<std::vector<export_job>> Jobs of each worker thread.
+ */
+std::vector<std::vector<export_job>> create_jobs(const std::map<rs::stream, std::pair<uint32_t, uint32_t>> & streams_ranges, unsigned int threads_count);
+
+/** @brief export_worker
+ *
+ * Read, decode and write the frames of the given jobs.
+ * @param[in] reader        Frame reader, owned by this worker.
+ * @param[in] jobs          Frames ranges to export.
+ * @param[in] settings      Export configuration.
+ * @param[out] exported     Counter of exported frames, shared by all workers.
+ * @param[out] failed       Counter of frames which failed to export, shared by all workers.
+ */
+void export_worker(rs::playback::frame_reader_interface * reader, const std::vector<export_job> & jobs, const export_settings & settings,
+                   std::atomic<uint64_t> & exported, std::atomic<uint64_t> & failed);
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        export_cmd_util cmd_utility;
+        rs::utils::cmd_option opt;
+        if(!cmd_utility.parse(argc, argv) || cmd_utility.get_cmd_option("-h --h -help --help -?", opt) || cmd_utility.get_file_path().empty())
+        {
+            std::cout << cmd_utility.get_help();
+            return cmd_utility.get_cmd_option("-h --h -help --help -?", opt) ? 0 : -1;
+        }
+
+        export_settings settings = {};
+        settings.output_directory = cmd_utility.get_output_directory();
+        settings.format = cmd_utility.get_format();
+
+        rs::playback::context context(cmd_utility.get_file_path().c_str());
+        if(context.get_device_count() == 0)
+            throw std::runtime_error("failed to open the recording - " + cmd_utility.get_file_path());
+        auto device = context.get_playback_device();
+
+        //one reader per worker thread, each one reads the file with its own file handles and decoders
+        auto threads_count = cmd_utility.get_threads_count();
+        std::vector<rs::utils::unique_ptr<rs::playback::frame_reader_interface>> readers;
+        for(unsigned int i = 0; i < threads_count; i++)
+        {
+            readers.push_back(get_unique_ptr_with_releaser(context.create_frame_reader()));
+            if(!readers.back())
+                throw std::runtime_error("failed to create frame reader");
+        }
+
+        const std::map<rs::stream, std::string> streams_tags = {{rs::stream::depth, "-d"}, {rs::stream::color, "-c"}, {rs::stream::infrared, "-i"},
+                                                                {rs::stream::infrared2, "-i2"}, {rs::stream::fisheye, "-f"}};
+        bool any_stream_selected = false;
+        for(auto & stream_tag : streams_tags)
+            any_stream_selected |= cmd_utility.is_stream_selected(stream_tag.second);
+
+        uint32_t first = 0, last = std::numeric_limits<uint32_t>::max();
+        cmd_utility.get_range(first, last);
+
+        std::map<rs::stream, std::pair<uint32_t, uint32_t>> streams_ranges;
+        uint64_t total_frames = 0;
+        for(auto & stream_tag : streams_tags)
+        {
+            auto stream = stream_tag.first;
+            if(any_stream_selected && !cmd_utility.is_stream_selected(stream_tag.second))
+                continue;
+            auto frame_count = readers[0]->get_frame_count(stream);
+            if(frame_count <= 0)
+                continue;
+            if(settings.format == "ply" && stream != rs::stream::depth)
+            {
+                std::cout << "point clouds are exported only from the depth stream, skipping " << stream_type_to_string(stream) << " stream" << std::endl;
+                continue;
+            }
+            auto end = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(last) + 1, static_cast<uint64_t>(frame_count)));
+            if(first >= end)
+                continue;
+            streams_ranges[stream] = std::make_pair(first, end);
+            total_frames += end - first;
+            std::cout << "exporting " << stream_type_to_string(stream) << " frames " << first << " to " << end - 1 << std::endl;
+        }
+        if(total_frames == 0)
+        {
+            std::cout << "no frames to export" << std::endl;
+            return 0;
+        }
+
+        if(streams_ranges.find(rs::stream::depth) != streams_ranges.end())
+        {
+            settings.depth_intrinsics = device->get_stream_intrinsics(rs::stream::depth);
+            settings.depth_scale = device->get_depth_scale();
+        }
+
+#ifdef WIN32
+        _mkdir(settings.output_directory.c_str());
+#else
+        mkdir(settings.output_directory.c_str(), 0755);
+#endif
+
+        auto jobs = create_jobs(streams_ranges, threads_count);
+        std::atomic<uint64_t> exported(0), failed(0);
+        auto start_time = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for(unsigned int i = 0; i < threads_count; i++)
+        {
+            workers.push_back(std::thread(export_worker, readers[i].get(), std::cref(jobs[i]), std::cref(settings), std::ref(exported), std::ref(failed)));
+        }
+
+        while(exported + failed < total_frames)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            std::cout << "\rexported " << exported << " / " << total_frames << " frames" << std::flush;
+        }
+        for(auto & worker : workers)
+            worker.join();
+
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << std::endl << "done exporting " << exported << " frames in " << static_cast<double>(duration) / 1000.0 << " seconds";
+        if(failed > 0)
+            std::cout << ", " << failed << " frames failed to export";
+        std::cout << std::endl;
+
+        return failed > 0 ? -1 : 0;
+    }
+    catch(const rs::error & e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    catch(const std::exception & e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+    catch(const std::string & e)
+    {
+        std::cout << e << std::endl;
+        return -1;
+    }
+}
+
+std::string stream_type_to_string(rs::stream stream)
+{
+    switch(stream)
+    {
+        case rs::stream::depth: return "depth";
+        case rs::stream::color: return "color";
+        case rs::stream::infrared: return "infrared";
+        case rs::stream::infrared2: return "infrared2";
+        case rs::stream::fisheye: return "fisheye";
+        default: return "";
+    }
+}
+
+std::vector<std::vector<export_job>> create_jobs(const std::map<rs::stream, std::pair<uint32_t, uint32_t>> & streams_ranges, unsigned int threads_count)
+{
+    std::vector<std::vector<export_job>> jobs(threads_count);
+    for(auto & stream_range : streams_ranges)
+    {
+        auto first = stream_range.second.first;
+        auto count = stream_range.second.second - first;
+        for(unsigned int i = 0; i < threads_count; i++)
+        {
+            auto job_first = first + static_cast<uint32_t>(static_cast<uint64_t>(count) * i / threads_count);
+            auto job_end = first + static_cast<uint32_t>(static_cast<uint64_t>(count) * (i + 1) / threads_count);
+            if(job_first < job_end)
+                jobs[i].push_back({stream_range.first, job_first, job_end});
+        }
+    }
+    return jobs;
+}
+
+void export_worker(rs::playback::frame_reader_interface * reader, const std::vector<export_job> & jobs, const export_settings & settings,
+                   std::atomic<uint64_t> & exported, std::atomic<uint64_t> & failed)
+{
+    for(auto & job : jobs)
+    {
+        for(uint32_t index = job.first; index < job.end; index++)
+        {
+            bool succeeded = false;
+            try
+            {
+                auto image = get_unique_ptr_with_releaser(reader->read(job.stream, index));
+                if(image)
+                {
+                    std::stringstream path;
+                    path << settings.output_directory << "/" << stream_type_to_string(job.stream) << "_" << std::setw(6) << std::setfill('0') << index << "." << settings.format;
+                    if(settings.format == "png")
+                        succeeded = write_png(path.str(), image.get());
+                    else if(settings.format == "ply")
+                        succeeded = write_ply(path.str(), image.get(), settings.depth_intrinsics, settings.depth_scale);
+                    else
+                        succeeded = write_raw(path.str(), image.get());
+                }
+            }
+            catch(...)
+            {
+                succeeded = false;
+            }
+            if(succeeded)
+                exported++;
+            else
+                failed++;
+        }
+    }
+}
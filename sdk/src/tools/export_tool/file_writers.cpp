@@ -0,0 +1,116 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <fstream>
+#include <vector>
+#include <stdint.h>
+#include <librealsense/rsutil.h>
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+#include "file_writers.h"
+
+using namespace rs::core;
+
+namespace
+{
+    //fast deflate level, higher levels make the export bound by the png encoding rather than by the file read and decode
+    const int PNG_COMPRESSION_LEVEL = 1;
+
+    //opencv matrix type of the image pixel format, and the conversion of the pixels to the opencv bgr channels order, -1 if none is required
+    bool query_cv_layout(pixel_format format, int & cv_type, int & color_conversion)
+    {
+        color_conversion = -1;
+        switch(format)
+        {
+            case pixel_format::z16:
+            case pixel_format::disparity16:
+            case pixel_format::y16:
+            case pixel_format::raw16: cv_type = CV_16UC1; return true;
+            case pixel_format::y8:
+            case pixel_format::raw8: cv_type = CV_8UC1; return true;
+            case pixel_format::rgb8: cv_type = CV_8UC3; color_conversion = cv::COLOR_RGB2BGR; return true;
+            case pixel_format::bgr8: cv_type = CV_8UC3; return true;
+            case pixel_format::rgba8: cv_type = CV_8UC4; color_conversion = cv::COLOR_RGBA2BGRA; return true;
+            case pixel_format::bgra8: cv_type = CV_8UC4; return true;
+            default: return false;
+        }
+    }
+
+    bool write_file(const std::string & path, const uint8_t * data, size_t size)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if(!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+        return file.good();
+    }
+}
+
+bool write_raw(const std::string & path, const image_interface * image)
+{
+    auto info = image->query_info();
+    return write_file(path, static_cast<const uint8_t *>(image->query_data()), static_cast<size_t>(info.pitch) * static_cast<size_t>(info.height));
+}
+
+bool write_png(const std::string & path, const image_interface * image)
+{
+    auto info = image->query_info();
+    int cv_type = 0, color_conversion = -1;
+    if(!query_cv_layout(info.format, cv_type, color_conversion))
+        return false;
+
+    try
+    {
+        cv::Mat pixels(info.height, info.width, cv_type, const_cast<void *>(image->query_data()), static_cast<size_t>(info.pitch));
+        cv::Mat bgr_pixels;
+        if(color_conversion >= 0)
+            cv::cvtColor(pixels, bgr_pixels, color_conversion);
+        else
+            bgr_pixels = pixels;
+        std::vector<int> params = { cv::IMWRITE_PNG_COMPRESSION, PNG_COMPRESSION_LEVEL };
+        return cv::imwrite(path, bgr_pixels, params);
+    }
+    catch(const cv::Exception &)
+    {
+        return false;
+    }
+}
+
+bool write_ply(const std::string & path, const image_interface * depth, const rs::intrinsics & depth_intrinsics, float depth_scale)
+{
+    auto info = depth->query_info();
+    if(info.format != pixel_format::z16)
+        return false;
+
+    std::vector<float> points;
+    points.reserve(static_cast<size_t>(info.width * info.height * 3));
+    auto data = static_cast<const uint8_t *>(depth->query_data());
+    for(int y = 0; y < info.height; y++)
+    {
+        auto row = reinterpret_cast<const uint16_t *>(data + static_cast<size_t>(y) * static_cast<size_t>(info.pitch));
+        for(int x = 0; x < info.width; x++)
+        {
+            if(row[x] == 0)
+                continue;
+            float pixel[2] = { static_cast<float>(x), static_cast<float>(y) };
+            float point[3];
+            rs_deproject_pixel_to_point(point, &depth_intrinsics, pixel, static_cast<float>(row[x]) * depth_scale);
+            points.insert(points.end(), point, point + 3);
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+    //the points are written in the host byte order, which is little endian on all supported platforms
+    file << "ply\n"
+         << "format binary_little_endian 1.0\n"
+         << "element vertex " << points.size() / 3 << "\n"
+         << "property float x\n"
+         << "property float y\n"
+         << "property float z\n"
+         << "end_header\n";
+    file.write(reinterpret_cast<const char *>(points.data()), static_cast<std::streamsize>(points.size() * sizeof(float)));
+    return file.good();
+}
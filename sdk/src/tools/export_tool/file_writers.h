@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <librealsense/rs.hpp>
+#include "rs/core/image_interface.h"
+
+/** @brief write_raw
+ *
+ * Write the image data to a binary file, as stored in the image - height rows of pitch bytes.
+ * @param[in] path      Output file path.
+ * @param[in] image     Image to write.
+ * @return: true        The file was written.
+ */
+bool write_raw(const std::string & path, const rs::core::image_interface * image);
+
+/** @brief write_png
+ *
+ * Write the image to a png file. Depth and 16 bit gray images are written as 16 bit grayscale,
+ * 8 bit gray images as 8 bit grayscale and color images as rgb or rgba.
+ * The image is encoded by opencv with a fast deflate level, to keep the export bound by the file read and decode time.
+ * @param[in] path      Output file path.
+ * @param[in] image     Image to write.
+ * @return: true        The file was written.
+ * @return: false       The image pixel format is not supported or the file failed to open.
+ */
+bool write_png(const std::string & path, const rs::core::image_interface * image);
+
+/** @brief write_ply
+ *
+ * Deproject the depth image and write the valid points to a binary ply point cloud, in meters.
+ * @param[in] path              Output file path.
+ * @param[in] depth             Depth image in z16 pixel format.
+ * @param[in] depth_intrinsics  Depth stream intrinsics.
+ * @param[in] depth_scale       Depth units in meters.
+ * @return: true                The file was written.
+ */
+bool write_ply(const std::string & path, const rs::core::image_interface * depth, const rs::intrinsics & depth_intrinsics, float depth_scale);
@@ -2,17 +2,28 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <stdio.h>
+#include <string.h>
 #include <map>
 #include <chrono>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <algorithm>
+#include <condition_variable>
 #include "gtest/gtest.h"
 #include "rs/playback/playback_device.h"
 #include "rs/playback/playback_context.h"
 #include "rs/record/record_context.h"
+#include "rs/record/transcoder.h"
 #include "librealsense/rs.hpp"
 #include "file_types.h"
+#include "disk_read.h"
+#include "overwrite_ring.h"
 #include "rs/utils/librealsense_conversion_utils.h"
+#include "rs/utils/smart_ptr_helpers.h"
 #include "viewer.h"
 #include "utilities/utilities.h"
 #include "include/rs_sdk_version.h"
@@ -326,6 +337,71 @@ namespace playback_tests_util
                 playback_tests_util::record_callback_no_motion(device);
         }
     }
+
+    //a reader which doesn't index the file until it is released, so the recording can be queried before the indexing completes
+    class gated_disk_read : public rs::playback::disk_read
+    {
+    public:
+        gated_disk_read(const char *file_path) : disk_read(file_path), m_is_released(false) {}
+
+        virtual ~gated_disk_read()
+        {
+            release();
+            stop_indexing();
+        }
+
+        void release()
+        {
+            std::lock_guard<std::mutex> guard(m_gate_mutex);
+            m_is_released = true;
+            m_gate_cv.notify_all();
+        }
+
+        bool is_index_complete() { return m_is_index_complete; }
+
+        void wait_for_index() { wait_for_samples(std::numeric_limits<uint32_t>::max()); }
+
+    protected:
+        virtual void index_next_samples(uint32_t number_of_samples) override
+        {
+            std::unique_lock<std::mutex> guard(m_gate_mutex);
+            m_gate_cv.wait(guard, [this]() { return m_is_released; });
+            guard.unlock();
+            disk_read::index_next_samples(number_of_samples);
+        }
+
+    private:
+        std::mutex              m_gate_mutex;
+        std::condition_variable m_gate_cv;
+        bool                    m_is_released;
+    };
+
+    //copies a recording and clears its streams frames counts, which are written to the header only when the recording is closed
+    static void copy_as_unclosed_recording(const std::string & source_path, const std::string & target_path)
+    {
+        {
+            std::ifstream source(source_path, std::ios::binary);
+            std::ofstream target(target_path, std::ios::binary);
+            target << source.rdbuf();
+        }
+        std::fstream file(target_path, std::ios::binary | std::ios::in | std::ios::out);
+        std::streamoff pos = sizeof(disk_format::file_header);
+        chunk_info chunk = {};
+        while(file.seekg(pos) && file.read(reinterpret_cast<char*>(&chunk), sizeof(chunk)) && chunk.id != chunk_id::chunk_sample_info)
+        {
+            pos += sizeof(chunk);
+            if(chunk.id == chunk_id::chunk_stream_info)
+            {
+                const int32_t nframes = 0;
+                for(uint32_t offset = 0; offset < chunk.size; offset += sizeof(disk_format::stream_info))
+                {
+                    file.seekp(pos + offset + static_cast<std::streamoff>(offsetof(file_types::stream_info, nframes)));
+                    file.write(reinterpret_cast<const char*>(&nframes), sizeof(nframes));
+                }
+            }
+            pos += chunk.size;
+        }
+    }
 }
 
 class playback_streaming_fixture : public testing::TestWithParam<std::string>
@@ -702,6 +778,199 @@ TEST_P(playback_streaming_fixture, get_frame_data)
     }
 }
 
+TEST_P(playback_streaming_fixture, frame_reader_parallel_read)
+{
+    auto reader = rs::utils::get_unique_ptr_with_releaser(context->create_frame_reader());
+    ASSERT_NE(nullptr, reader.get());
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        auto stream = it->first;
+        auto frame_count = reader->get_frame_count(stream);
+        EXPECT_EQ(device->get_frame_count(stream), frame_count);
+
+        const int threads_count = 4;
+        std::vector<std::thread> threads;
+        std::vector<int> errors(threads_count, 0);
+        for(int t = 0; t < threads_count; t++)
+        {
+            threads.push_back(std::thread([&, t]()
+            {
+                for(int i = t; i < frame_count; i += threads_count)
+                {
+                    auto image = rs::utils::get_unique_ptr_with_releaser(reader->read(stream, i));
+                    if(!image || !image->query_data() || image->query_info().width != it->second.info.width)
+                        errors[t]++;
+                }
+            }));
+        }
+        for(auto & thread : threads)
+            thread.join();
+        for(auto error : errors)
+            EXPECT_EQ(0, error);
+        EXPECT_EQ(nullptr, rs::utils::get_unique_ptr_with_releaser(reader->read(stream, frame_count)).get());
+    }
+}
+
+TEST_P(playback_streaming_fixture, transcode)
+{
+    //uncompressed and lz4 compressed targets, both are lossless
+    for(auto compression : {rs::record::compression_level::disabled, rs::record::compression_level::high})
+    {
+        SCOPED_TRACE("compression level " + std::to_string(static_cast<int>(compression)));
+        const std::string target_file = "rstest_transcoded.rssdk";
+        rs::record::transcoder transcoder(GetParam().c_str(), target_file.c_str());
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+            transcoder.set_compression(it->first, compression);
+        transcoder.set_threads_count(4);
+        ASSERT_EQ(rs::core::status_no_error, transcoder.run());
+        EXPECT_GT(transcoder.get_transcoded_samples_count(), 0u);
+
+        {
+            rs::playback::context target_context(target_file.c_str());
+            ASSERT_EQ(1, target_context.get_device_count());
+            auto source_reader = rs::utils::get_unique_ptr_with_releaser(context->create_frame_reader());
+            auto target_reader = rs::utils::get_unique_ptr_with_releaser(target_context.create_frame_reader());
+            ASSERT_NE(nullptr, target_reader.get());
+            for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+            {
+                auto stream = it->first;
+                auto frame_count = source_reader->get_frame_count(stream);
+                ASSERT_EQ(frame_count, target_reader->get_frame_count(stream));
+                for(int i = 0; i < frame_count; i += 10)
+                {
+                    auto source_image = rs::utils::get_unique_ptr_with_releaser(source_reader->read(stream, i));
+                    auto target_image = rs::utils::get_unique_ptr_with_releaser(target_reader->read(stream, i));
+                    ASSERT_NE(nullptr, source_image.get());
+                    ASSERT_NE(nullptr, target_image.get());
+                    auto info = source_image->query_info();
+                    EXPECT_EQ(source_image->query_time_stamp(), target_image->query_time_stamp());
+                    EXPECT_EQ(0, memcmp(source_image->query_data(), target_image->query_data(), static_cast<size_t>(info.pitch * info.height)));
+                }
+            }
+        }
+        ::remove(target_file.c_str());
+    }
+}
+
+TEST_P(playback_streaming_fixture, shared_recording)
+{
+    rs::playback::shared_recording recording(GetParam().c_str());
+    ASSERT_TRUE(recording.is_open());
+
+    //each view streams independently, with its own clock and read position
+    const int views_count = 3;
+    std::vector<std::unique_ptr<rs::playback::context>> contexts;
+    std::vector<std::map<rs::stream, int>> frame_count(views_count);
+    std::mutex mutex;
+    for(int i = 0; i < views_count; i++)
+    {
+        contexts.push_back(std::unique_ptr<rs::playback::context>(new rs::playback::context(recording)));
+        ASSERT_EQ(1, contexts.back()->get_device_count());
+        auto view = contexts.back()->get_playback_device();
+        playback_tests_util::enable_available_streams(view);
+        view->set_real_time(false);
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        {
+            rs::stream stream = it->first;
+            EXPECT_EQ(device->get_frame_count(stream), view->get_frame_count(stream));
+            view->set_frame_callback(stream, [i, stream, &frame_count, &mutex](rs::frame entry)
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                frame_count[i][stream]++;
+            });
+        }
+    }
+
+    for(auto & context : contexts)
+        context->get_playback_device()->start();
+    for(auto & context : contexts)
+    {
+        auto view = context->get_playback_device();
+        auto start_time = std::chrono::steady_clock::now();
+        while(view->is_streaming() && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(30))
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        EXPECT_FALSE(view->is_streaming());
+        view->stop();
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    for(int i = 0; i < views_count; i++)
+    {
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+            EXPECT_EQ(device->get_frame_count(it->first), frame_count[i][it->first]);
+    }
+}
+
+TEST_P(playback_streaming_fixture, frame_count_before_indexing)
+{
+    //the counts the recorder wrote to the header are returned while the file isn't indexed
+    std::map<rs_stream, uint32_t> header_frame_count;
+    {
+        playback_tests_util::gated_disk_read reader(GetParam().c_str());
+        ASSERT_EQ(status_no_error, reader.init());
+        auto streams_infos = reader.get_streams_infos();
+        for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+        {
+            auto stream = static_cast<rs_stream>(it->first);
+            header_frame_count[stream] = static_cast<uint32_t>(streams_infos[stream].nframes);
+            EXPECT_GT(header_frame_count[stream], 0u);
+            EXPECT_EQ(header_frame_count[stream], reader.query_number_of_frames(stream));
+        }
+        EXPECT_FALSE(reader.is_index_complete());
+
+        //the indexed counts match the header counts
+        reader.release();
+        reader.wait_for_index();
+        ASSERT_TRUE(reader.is_index_complete());
+        for(auto & count : header_frame_count)
+            EXPECT_EQ(count.second, reader.query_number_of_frames(count.first));
+        EXPECT_EQ(static_cast<int>(header_frame_count[static_cast<rs_stream>(rs::stream::depth)]), device->get_frame_count(rs::stream::depth));
+    }
+
+    //a recording which wasn't closed has no header counts, the frames are counted once the file is indexed
+    const std::string unclosed_file = "rstest_unclosed.rssdk";
+    playback_tests_util::copy_as_unclosed_recording(GetParam(), unclosed_file);
+    {
+        playback_tests_util::gated_disk_read reader(unclosed_file.c_str());
+        ASSERT_EQ(status_no_error, reader.init());
+        auto streams_infos = reader.get_streams_infos();
+        for(auto & count : header_frame_count)
+            EXPECT_EQ(0, streams_infos[count.first].nframes);
+        auto counted_frames = std::async(std::launch::async, [&reader, &header_frame_count]()
+        {
+            std::map<rs_stream, uint32_t> frame_count;
+            for(auto & count : header_frame_count)
+                frame_count[count.first] = reader.query_number_of_frames(count.first);
+            return frame_count;
+        });
+        EXPECT_EQ(std::future_status::timeout, counted_frames.wait_for(std::chrono::milliseconds(100)));
+        reader.release();
+        EXPECT_EQ(header_frame_count, counted_frames.get());
+    }
+    ::remove(unclosed_file.c_str());
+}
+
+TEST_P(playback_streaming_fixture, frame_cache)
+{
+    const uint64_t cache_size = 32 * 1024 * 1024;
+    device->set_frame_cache_size(cache_size);
+    EXPECT_EQ(cache_size, device->get_frame_cache_size());
+    playback_tests_util::enable_available_streams(device);
+    auto stream = setup::profiles.begin()->first;
+
+    //a cached frame is returned without reading the file again
+    device->set_frame_by_index(5, stream);
+    auto data = device->get_frame_data(stream);
+    device->set_frame_by_index(6, stream);
+    device->set_frame_by_index(5, stream);
+    EXPECT_EQ(data, device->get_frame_data(stream));
+
+    device->set_frame_cache_size(0);
+    EXPECT_EQ(0u, device->get_frame_cache_size());
+    device->set_frame_by_index(6, stream);
+    EXPECT_NE(nullptr, device->get_frame_data(stream));
+}
+
 TEST_P(playback_streaming_fixture, is_real_time)
 {
     device->set_real_time(false);
@@ -710,6 +979,64 @@ TEST_P(playback_streaming_fixture, is_real_time)
     EXPECT_TRUE(device->is_real_time());
 }
 
+TEST_P(playback_streaming_fixture, set_playback_speed)
+{
+    EXPECT_DOUBLE_EQ(1.0, device->get_playback_speed());
+    EXPECT_FALSE(device->set_playback_speed(0.01));
+    EXPECT_FALSE(device->set_playback_speed(64.0));
+    EXPECT_DOUBLE_EQ(1.0, device->get_playback_speed());
+
+    //prevent from runnimg async file with wait for frames
+    rs::playback::file_info file_info = device->get_file_info();
+    if(file_info.capture_mode == rs::playback::capture_mode::asynced) return;
+
+    playback_tests_util::enable_available_streams(device);
+    EXPECT_TRUE(device->set_playback_speed(4.0));
+    EXPECT_DOUBLE_EQ(4.0, device->get_playback_speed());
+    auto stream = setup::profiles.begin()->first;
+    device->start();
+    device->wait_for_frames();
+    auto first_time_stamp = device->get_frame_timestamp(stream);
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 0; i < 30 && device->is_streaming(); i++)
+    {
+        device->wait_for_frames();
+    }
+    auto recorded_ms = device->get_frame_timestamp(stream) - first_time_stamp;
+    auto played_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    device->stop();
+    //4x playback plays the recorded time span in about a quarter of it, half of it leaves a margin for the machine load
+    ASSERT_GT(recorded_ms, 0.0);
+    EXPECT_LT(played_ms, recorded_ms / 2);
+    EXPECT_GT(device->get_achieved_playback_speed(), 1.0);
+}
+
+TEST_P(playback_streaming_fixture, timing_stats)
+{
+    playback_tests_util::enable_available_streams(device);
+    device->set_real_time(true);
+
+    std::atomic<int> callbacks_count(0);
+    auto callback = [&callbacks_count](rs::frame f) { callbacks_count++; };
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        device->set_frame_callback(it->first, callback);
+    }
+
+    device->start();
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    auto stats = device->get_timing_stats();
+    device->stop();
+
+    EXPECT_GT(callbacks_count.load(), 0);
+    EXPECT_GT(stats.samples_count, 0u);
+    EXPECT_GE(stats.average_delay, 0.0);
+    EXPECT_GE(stats.max_delay, stats.average_delay);
+    EXPECT_GE(stats.max_jitter, stats.average_jitter);
+    //samples are scheduled against absolute deadlines, the average delay should stay well below a frame interval
+    EXPECT_LT(stats.average_delay, 10000.0);
+}
+
 TEST_P(playback_streaming_fixture, non_real_time_playback)
 {
     //prevent from runnimg async file with wait for frames
@@ -737,6 +1064,108 @@ TEST_P(playback_streaming_fixture, non_real_time_playback)
     device->stop();
 }
 
+TEST_P(playback_streaming_fixture, reverse_playback)
+{
+    //prevent from runnimg async file with wait for frames
+    rs::playback::file_info file_info = device->get_file_info();
+    if(file_info.capture_mode == rs::playback::capture_mode::asynced) return;
+
+    playback_tests_util::enable_available_streams(device);
+    EXPECT_FALSE(device->is_reverse_playback());
+
+    auto stream = setup::profiles.begin()->first;
+    device->set_frame_by_index(20, stream);
+    device->set_real_time(false);
+    device->set_reverse_playback(true);
+    EXPECT_TRUE(device->is_reverse_playback());
+    unsigned long long prev = device->get_frame_number(stream);
+    device->start();
+    for(int i = 0; i < 10; i++)
+    {
+        device->wait_for_frames();
+        auto frame_number = device->get_frame_number(stream);
+        EXPECT_EQ(prev - 1, frame_number);
+        prev = frame_number;
+    }
+    device->stop();
+}
+
+TEST_P(playback_streaming_fixture, playback_range)
+{
+    playback_tests_util::enable_available_streams(device);
+    EXPECT_FALSE(device->set_playback_range(2000000, 1000000));
+    EXPECT_FALSE(device->set_playback_range(3600000000, 3700000000));
+
+    //a second of the recording, starting two seconds after the recording start
+    ASSERT_TRUE(device->set_playback_range(2000000, 3000000));
+    device->set_real_time(false);
+
+    std::mutex mutex;
+    std::map<rs::stream, int> frame_count;
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        rs::stream stream = it->first;
+        device->set_frame_callback(stream, [stream, &frame_count, &mutex](rs::frame entry)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            frame_count[stream]++;
+        });
+    }
+
+    device->start();
+    auto start_time = std::chrono::steady_clock::now();
+    while(device->is_streaming() && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10))
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_FALSE(device->is_streaming());
+    device->stop();
+
+    std::lock_guard<std::mutex> guard(mutex);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        auto fps = it->second.frame_rate;
+        EXPECT_NEAR(fps, frame_count[it->first], fps / 3);
+    }
+}
+
+TEST_P(playback_streaming_fixture, loop_playback)
+{
+    playback_tests_util::enable_available_streams(device);
+    EXPECT_FALSE(device->is_loop_playback());
+    ASSERT_TRUE(device->set_playback_range(0, 1000000));
+    device->set_loop_playback(true);
+    EXPECT_TRUE(device->is_loop_playback());
+    device->set_real_time(false);
+
+    auto stream = setup::profiles.begin()->first;
+    std::mutex mutex;
+    std::vector<double> time_stamps;
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        rs::stream s = it->first;
+        device->set_frame_callback(s, [s, stream, &time_stamps, &mutex](rs::frame entry)
+        {
+            if(s != stream) return;
+            std::lock_guard<std::mutex> guard(mutex);
+            time_stamps.push_back(entry.get_timestamp());
+        });
+    }
+
+    device->start();
+    auto start_time = std::chrono::steady_clock::now();
+    while(device->get_loop_count() < 3 && std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10))
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    //the playback doesn't end at the end of the range
+    EXPECT_GE(device->get_loop_count(), 3u);
+    EXPECT_TRUE(device->is_streaming());
+    device->stop();
+
+    std::lock_guard<std::mutex> guard(mutex);
+    auto fps = setup::profiles.begin()->second.frame_rate;
+    EXPECT_GT(time_stamps.size(), static_cast<size_t>(fps * 3));
+    for(size_t i = 1; i < time_stamps.size(); i++)
+        EXPECT_GT(time_stamps[i], time_stamps[i - 1]);
+}
+
 TEST_P(playback_streaming_fixture, pause)
 {
     //prevent from runnimg async file with wait for frames
@@ -1007,6 +1436,169 @@ TEST_P(playback_streaming_fixture, frames_callback)
     }
 }
 
+TEST_P(playback_streaming_fixture, callback_queue_depth)
+{
+    EXPECT_FALSE(device->set_callback_queue_depth(0));
+    EXPECT_FALSE(device->set_callback_queue_depth(257));
+    const uint32_t depth = 8;
+    EXPECT_TRUE(device->set_callback_queue_depth(depth));
+    EXPECT_EQ(depth, device->get_callback_queue_depth());
+
+    playback_tests_util::enable_available_streams(device);
+    device->set_real_time(true);
+
+    std::atomic<int> callbacks_count(0);
+    auto callback = [&callbacks_count](rs::frame f)
+    {
+        //stall the callback thread every few frames, queued frames should be delivered once it resumes
+        if(++callbacks_count % 10 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    };
+
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        device->set_frame_callback(it->first, callback);
+    }
+
+    device->start();
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    device->stop();
+
+    EXPECT_GT(callbacks_count.load(), 0);
+    for(auto it = setup::profiles.begin(); it != setup::profiles.end(); ++it)
+    {
+        auto high_water_mark = device->get_callback_queue_high_water_mark(it->first);
+        EXPECT_GT(high_water_mark, 1u);
+        EXPECT_LE(high_water_mark, depth);
+    }
+}
+
+TEST_P(playback_streaming_fixture, callback_queue_policy)
+{
+    EXPECT_EQ(rs::playback::callback_queue_policy::drop_oldest, device->get_callback_queue_policy());
+    device->set_callback_queue_policy(rs::playback::callback_queue_policy::drop_newest);
+    EXPECT_EQ(rs::playback::callback_queue_policy::drop_newest, device->get_callback_queue_policy());
+
+    ASSERT_GT(setup::profiles.size(), 1u);
+    auto stream = setup::profiles.begin()->first;
+    auto other_stream = std::next(setup::profiles.begin())->first;
+
+    //the recorded frames numbers of the stream, in the file order
+    const int recorded_count = 32;
+    std::vector<unsigned long long> recorded_numbers;
+    {
+        auto reader = rs::utils::get_unique_ptr_with_releaser(context->create_frame_reader());
+        for(int i = 0; i < recorded_count; i++)
+        {
+            auto image = rs::utils::get_unique_ptr_with_releaser(reader->read(stream, i));
+            ASSERT_NE(nullptr, image.get());
+            recorded_numbers.push_back(image->query_frame_number());
+        }
+    }
+
+    for(auto policy : {rs::playback::callback_queue_policy::drop_newest, rs::playback::callback_queue_policy::drop_oldest})
+    {
+        SCOPED_TRACE("callback queue policy " + std::to_string(static_cast<int>(policy)));
+        rs::playback::context policy_context(GetParam().c_str());
+        auto policy_device = policy_context.get_playback_device();
+        ASSERT_NE(nullptr, policy_device);
+        playback_tests_util::enable_available_streams(policy_device);
+        policy_device->set_real_time(true);
+        policy_device->set_callback_queue_policy(policy);
+        const uint32_t depth = policy_device->get_callback_queue_depth();
+        ASSERT_LT(depth + 2, static_cast<uint32_t>(recorded_count));
+
+        std::vector<unsigned long long> frame_numbers;
+        uint32_t other_stream_count = 0;
+        bool is_released = false;
+        std::mutex mutex;
+        std::condition_variable cv;
+        //the callback thread is held on the first frame until the reader queued more frames than the queue depth,
+        //the other stream, which is read by the same reader, tells how far the reader went
+        policy_device->set_frame_callback(stream, [&](rs::frame f)
+        {
+            std::unique_lock<std::mutex> guard(mutex);
+            frame_numbers.push_back(f.get_frame_number());
+            cv.notify_all();
+            cv.wait(guard, [&]() { return is_released; });
+        });
+        policy_device->set_frame_callback(other_stream, [&](rs::frame f)
+        {
+            std::lock_guard<std::mutex> guard(mutex);
+            other_stream_count++;
+            cv.notify_all();
+        });
+
+        policy_device->start();
+        bool is_queue_overflowed = false;
+        bool is_queue_delivered = false;
+        {
+            std::unique_lock<std::mutex> guard(mutex);
+            is_queue_overflowed = cv.wait_for(guard, std::chrono::seconds(10), [&]() { return other_stream_count > depth + 4; });
+            is_released = true;
+            cv.notify_all();
+            is_queue_delivered = cv.wait_for(guard, std::chrono::seconds(10), [&]() { return frame_numbers.size() > depth + 1; });
+        }
+        policy_device->stop();
+        ASSERT_TRUE(is_queue_overflowed);
+        ASSERT_TRUE(is_queue_delivered);
+
+        auto first = std::find(recorded_numbers.begin(), recorded_numbers.end(), frame_numbers[0]);
+        ASSERT_NE(recorded_numbers.end(), first);
+        auto first_index = static_cast<uint32_t>(first - recorded_numbers.begin());
+        ASSERT_LT(first_index + depth + 1, static_cast<uint32_t>(recorded_count));
+        if(policy == rs::playback::callback_queue_policy::drop_newest)
+        {
+            //the frames queued while the callback was held are delivered in order, the frames which followed them were dropped
+            for(uint32_t i = 1; i <= depth; i++)
+                EXPECT_EQ(recorded_numbers[first_index + i], frame_numbers[i]) << "frame " << i;
+            EXPECT_GT(frame_numbers[depth + 1], recorded_numbers[first_index + depth + 1]);
+        }
+        else
+        {
+            //the oldest queued frames were replaced by the most recent frames
+            EXPECT_GT(frame_numbers[1], recorded_numbers[first_index + 1]);
+            for(uint32_t i = 2; i <= depth; i++)
+                EXPECT_GT(frame_numbers[i], frame_numbers[i - 1]) << "frame " << i;
+        }
+    }
+}
+
+TEST(playback_overwrite_ring, push_and_push_overwrite)
+{
+    rs::playback::overwrite_ring<int> ring;
+    int value = 0;
+    EXPECT_FALSE(ring.push(0));
+    EXPECT_FALSE(ring.pop(value));
+
+    ring.reset(3);
+    for(int i = 0; i < 3; i++)
+        EXPECT_TRUE(ring.push(i));
+    EXPECT_EQ(3u, ring.size());
+
+    //a full ring rejects a new element on push, and removes its oldest element on push_overwrite
+    EXPECT_FALSE(ring.push(3));
+    EXPECT_EQ(3u, ring.size());
+    EXPECT_EQ(1u, ring.push_overwrite(4));
+    EXPECT_EQ(3u, ring.size());
+    EXPECT_EQ(1u, ring.push_overwrite(5));
+    for(int expected : {2, 4, 5})
+    {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(expected, value);
+    }
+    EXPECT_FALSE(ring.pop(value));
+    EXPECT_TRUE(ring.empty());
+
+    //a ring with free slots takes the element without removing any
+    EXPECT_EQ(0u, ring.push_overwrite(6));
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(6, value);
+    EXPECT_EQ(3u, ring.high_water_mark());
+    ring.reset(3);
+    EXPECT_EQ(0u, ring.high_water_mark());
+}
+
 TEST_P(playback_streaming_fixture, playback_and_render_callbak)
 {
     auto stream_count = playback_tests_util::enable_available_streams(device);
@@ -4,8 +4,13 @@
 #include "projection_fixture.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <locale>
 #include <algorithm>
+#include <vector>
+#include <thread>
+#include "math_projection_interface.h"
+#include "projection_r200.h"
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/smart_ptr_helpers.h"
 
@@ -1457,3 +1462,964 @@ TEST_F(projection_fixture, create_color_image_mapped_to_depth_query_uvmap)
         }
     }
 }
+
+/*
+    Test:
+        parallel_queries_match_single_threaded
+
+    Target:
+        Checks the full image queries with multiple threads against the single threaded queries
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Gets UV Map, Inverse UV Map, vertices and Depth mapped to Color image of the same depth image with a single thread and with 4 threads.
+        The threads process separate rows bands, so the results are expected to be identical.
+
+    Pass Criteria:
+        Test passes if all the multi threaded results are equal to the single threaded results.
+*/
+TEST_F(projection_fixture, parallel_queries_match_single_threaded)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        m_device->set_frame_by_index(i, rs::stream::color);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+        int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+        image_info  ColorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&ColorInfo,
+                            {m_device->get_frame_data(rs::stream::color), nullptr},
+                            stream_type::color,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::color),
+                            m_device->get_frame_number(rs::stream::color)));
+
+        std::vector<pointF32> uvMap[2], invUvMap[2];
+        std::vector<point3dF32> vertices[2];
+        rs::utils::unique_ptr<image_interface> depth2color[2];
+        const uint32_t threads_count[2] = { 1, 4 };
+        for (int t = 0; t < 2; t++)
+        {
+            ASSERT_EQ(status_no_error, m_projection->set_threads_count(threads_count[t]));
+            uvMap[t].resize(m_depth_intrin.width * m_depth_intrin.height);
+            invUvMap[t].resize(m_color_intrin.width * m_color_intrin.height);
+            vertices[t].resize(m_depth_intrin.width * m_depth_intrin.height);
+            m_sts = m_projection->query_uvmap(depth.get(), uvMap[t].data());
+            if (m_sts == status_feature_unsupported) break;
+            ASSERT_EQ(status_no_error, m_sts);
+            ASSERT_EQ(status_no_error, m_projection->query_invuvmap(depth.get(), invUvMap[t].data()));
+            ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices[t].data()));
+            depth2color[t] = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+            ASSERT_NE(nullptr, depth2color[t]);
+        }
+        m_projection->set_threads_count(1);
+        if (m_sts == status_feature_unsupported) continue;
+
+        EXPECT_EQ(0, memcmp(uvMap[0].data(), uvMap[1].data(), uvMap[0].size() * sizeof(pointF32)));
+        EXPECT_EQ(0, memcmp(invUvMap[0].data(), invUvMap[1].data(), invUvMap[0].size() * sizeof(pointF32)));
+        EXPECT_EQ(0, memcmp(vertices[0].data(), vertices[1].data(), vertices[0].size() * sizeof(point3dF32)));
+        auto depth2color_info = depth2color[0]->query_info();
+        EXPECT_EQ(0, memcmp(depth2color[0]->query_data(), depth2color[1]->query_data(), static_cast<size_t>(depth2color_info.pitch * depth2color_info.height)));
+    }
+}
+
+/*
+    Test:
+        map_color_to_depth_batches_match_single_batch
+
+    Target:
+        Checks the mapping of color pixels to depth pixels in many batches of the same depth frame
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Maps a grid of color pixels with a single MapColorToDepth call and with a call per pixel.
+        The calls of the same depth frame share the frame mapping, so the results are expected to be identical.
+
+    Pass Criteria:
+        Test passes if the per pixel results are equal to the single batch results.
+*/
+TEST_F(projection_fixture, map_color_to_depth_batches_match_single_batch)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+
+        std::vector<pointF32> color_points;
+        for (int y = 0; y < m_color_intrin.height; y += 16)
+            for (int x = 0; x < m_color_intrin.width; x += 16)
+                color_points.push_back({static_cast<float>(x), static_cast<float>(y)});
+
+        std::vector<pointF32> batch_points(color_points.size());
+        m_sts = m_projection->map_color_to_depth(depth.get(), static_cast<int32_t>(color_points.size()), color_points.data(), batch_points.data());
+        if (m_sts == status_data_unavailable) continue;
+        for (size_t p = 0; p < color_points.size(); p++)
+        {
+            pointF32 point = {};
+            m_projection->map_color_to_depth(depth.get(), 1, &color_points[p], &point);
+            ASSERT_EQ(batch_points[p].x, point.x) << "point " << p;
+            ASSERT_EQ(batch_points[p].y, point.y) << "point " << p;
+        }
+    }
+}
+
+/*
+    Test:
+        map_color_to_depth_refilled_raw_buffer
+
+    Target:
+        Checks the mapping of color pixels to depth pixels of a depth buffer refilled in place
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Wraps a single depth buffer with an image of frame number and time stamp 0, maps a grid of color pixels,
+        copies the following depth frame into the same buffer and maps the grid again.
+        The image isn't identified by its frame, so the second call is expected to map the new content.
+
+    Pass Criteria:
+        Test passes if the second results are equal to the results of the following frame image.
+*/
+TEST_F(projection_fixture, map_color_to_depth_refilled_raw_buffer)
+{
+    const int32_t first_frame = 5;
+    if (projection_tests_util::total_frames < first_frame + 2) return;
+
+    int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+    image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+    std::vector<uint8_t> depth_buffer(DepthInfo.height * DepthInfo.pitch);
+    auto raw_depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                        {depth_buffer.data(), nullptr}, stream_type::depth, image_interface::flag::any, 0, 0));
+
+    std::vector<pointF32> color_points;
+    for (int y = 0; y < m_color_intrin.height; y += 16)
+        for (int x = 0; x < m_color_intrin.width; x += 16)
+            color_points.push_back({static_cast<float>(x), static_cast<float>(y)});
+    std::vector<pointF32> raw_points(color_points.size());
+    std::vector<pointF32> frame_points(color_points.size());
+
+    m_device->set_frame_by_index(first_frame, rs::stream::depth);
+    memcpy(depth_buffer.data(), m_device->get_frame_data(rs::stream::depth), depth_buffer.size());
+    m_sts = m_projection->map_color_to_depth(raw_depth.get(), static_cast<int32_t>(color_points.size()), color_points.data(), raw_points.data());
+    if (m_sts == status_data_unavailable) return;
+
+    m_device->set_frame_by_index(first_frame + 1, rs::stream::depth);
+    memcpy(depth_buffer.data(), m_device->get_frame_data(rs::stream::depth), depth_buffer.size());
+    m_sts = m_projection->map_color_to_depth(raw_depth.get(), static_cast<int32_t>(color_points.size()), color_points.data(), raw_points.data());
+    ASSERT_EQ(status_no_error, m_sts);
+
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                    {m_device->get_frame_data(rs::stream::depth), nullptr},
+                    stream_type::depth,
+                    image_interface::flag::any,
+                    m_device->get_frame_timestamp(rs::stream::depth),
+                    m_device->get_frame_number(rs::stream::depth)));
+    m_sts = m_projection->map_color_to_depth(depth.get(), static_cast<int32_t>(color_points.size()), color_points.data(), frame_points.data());
+    ASSERT_EQ(status_no_error, m_sts);
+    for (size_t p = 0; p < color_points.size(); p++)
+    {
+        ASSERT_EQ(frame_points[p].x, raw_points[p].x) << "point " << p;
+        ASSERT_EQ(frame_points[p].y, raw_points[p].y) << "point " << p;
+    }
+}
+
+/*
+    Test:
+        query_point_cloud_matches_separate_queries
+
+    Target:
+        Checks the colored point cloud query against the vertices and UV Map queries
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Gets the full resolution point cloud with its UV Map and colors, and compares it with QueryVertices and QueryUVMap of the same depth image.
+        The point cloud maps the points with the array projection, so the results are compared with a tolerance.
+        Gets a compact point cloud decimated by 2 and counts its points.
+
+    Pass Criteria:
+        Test passes if the points are within the tolerance of the separate queries, almost all the UV Map validity decisions agree,
+        and the compact point cloud holds exactly the decimated pixels with a valid depth.
+*/
+TEST_F(projection_fixture, query_point_cloud_matches_separate_queries)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        m_device->set_frame_by_index(i, rs::stream::color);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+        int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+        image_info  ColorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&ColorInfo,
+                            {m_device->get_frame_data(rs::stream::color), nullptr},
+                            stream_type::color,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::color),
+                            m_device->get_frame_number(rs::stream::color)));
+
+        const int32_t depth_size = m_depth_intrin.width * m_depth_intrin.height;
+        std::vector<pointF32> uvMap(depth_size);
+        std::vector<point3dF32> vertices(depth_size);
+        m_sts = m_projection->query_uvmap(depth.get(), uvMap.data());
+        if (m_sts == status_feature_unsupported) continue;
+        ASSERT_EQ(status_no_error, m_sts);
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+
+        const int32_t channels = get_pixel_size(ColorInfo.format);
+        std::vector<point3dF32> cloud_vertices(depth_size);
+        std::vector<pointF32> cloud_uvmap(depth_size);
+        std::vector<uint8_t> cloud_colors(depth_size * channels);
+        int32_t npoints = 0;
+        point_cloud_params params = { 1, 0.f, 0.f, false };
+        ASSERT_EQ(status_no_error, m_projection->query_point_cloud(depth.get(), color.get(), params, depth_size,
+                                                                   cloud_vertices.data(), cloud_uvmap.data(), cloud_colors.data(), &npoints));
+        ASSERT_EQ(depth_size, npoints);
+
+        int32_t validity_mismatches = 0;
+        for (int32_t p = 0; p < depth_size; p++)
+        {
+            ASSERT_NEAR(vertices[p].x, cloud_vertices[p].x, 0.01f) << "point " << p;
+            ASSERT_NEAR(vertices[p].y, cloud_vertices[p].y, 0.01f) << "point " << p;
+            ASSERT_EQ(vertices[p].z, cloud_vertices[p].z) << "point " << p;
+            if (vertices[p].z == 0) continue;
+            bool is_valid = uvMap[p].x >= 0.f && uvMap[p].y >= 0.f;
+            bool is_cloud_valid = cloud_uvmap[p].x >= 0.f && cloud_uvmap[p].y >= 0.f;
+            if (is_valid != is_cloud_valid)
+            {
+                validity_mismatches++;
+                continue;
+            }
+            if (!is_valid) continue;
+            ASSERT_NEAR(uvMap[p].x, cloud_uvmap[p].x, 0.0001f) << "point " << p;
+            ASSERT_NEAR(uvMap[p].y, cloud_uvmap[p].y, 0.0001f) << "point " << p;
+        }
+        //pixels which are projected exactly to the color image border may differ
+        EXPECT_LE(validity_mismatches, depth_size / 1000);
+
+        const int32_t decimation = 2;
+        const uint8_t* depth_data = static_cast<const uint8_t*>(depth->query_data());
+        int32_t decimated_valid = 0;
+        for (int32_t y = 0; y < m_depth_intrin.height; y += decimation)
+            for (int32_t x = 0; x < m_depth_intrin.width; x += decimation)
+                decimated_valid += reinterpret_cast<const uint16_t*>(depth_data + y * depthPitch)[x] != 0 ? 1 : 0;
+        params = { decimation, 0.f, 0.f, true };
+        ASSERT_EQ(status_no_error, m_projection->query_point_cloud(depth.get(), nullptr, params, depth_size,
+                                                                   cloud_vertices.data(), nullptr, nullptr, &npoints));
+        ASSERT_EQ(decimated_valid, npoints);
+        for (int32_t p = 0; p < npoints; p++)
+            ASSERT_NE(0.f, cloud_vertices[p].z) << "point " << p;
+    }
+}
+
+/*
+    Test:
+        concurrent_queries_match_serial
+
+    Target:
+        Checks a single projection instance which is used by several threads at once
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Gets UV Map, Depth mapped to Color image and the depth pixels of a grid of color pixels on the calling thread,
+        then gets them again from 4 threads which share the projection instance and the depth image.
+        The instance is not modified by the queries, so the results are expected to be identical.
+
+    Pass Criteria:
+        Test passes if the results of all the threads are equal to the calling thread results.
+*/
+TEST_F(projection_fixture, concurrent_queries_match_serial)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    const int32_t threads_count = 4;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        m_device->set_frame_by_index(i, rs::stream::color);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+        int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+        image_info  ColorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&ColorInfo,
+                            {m_device->get_frame_data(rs::stream::color), nullptr},
+                            stream_type::color,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::color),
+                            m_device->get_frame_number(rs::stream::color)));
+
+        std::vector<pointF32> color_points;
+        for (int y = 0; y < m_color_intrin.height; y += 16)
+            for (int x = 0; x < m_color_intrin.width; x += 16)
+                color_points.push_back({static_cast<float>(x), static_cast<float>(y)});
+
+        // index 0 holds the calling thread results, the other indexes the concurrent threads results
+        std::vector<pointF32> uvMap[threads_count + 1], depthPoints[threads_count + 1];
+        std::vector<uint8_t> depth2color[threads_count + 1];
+        status sts[threads_count + 1];
+        auto run_queries = [&](int t, image_interface *depth_image)
+        {
+            uvMap[t].resize(m_depth_intrin.width * m_depth_intrin.height);
+            depthPoints[t].resize(color_points.size());
+            sts[t] = m_projection->query_uvmap(depth_image, uvMap[t].data());
+            if (sts[t] != status_no_error) return;
+            sts[t] = m_projection->map_color_to_depth(depth_image, static_cast<int32_t>(color_points.size()), color_points.data(), depthPoints[t].data());
+            if (sts[t] < status_no_error) return;
+            auto image = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth_image, color.get()));
+            if (!image)
+            {
+                sts[t] = status_data_unavailable;
+                return;
+            }
+            auto data = static_cast<const uint8_t*>(image->query_data());
+            depth2color[t].assign(data, data + image->query_info().pitch * image->query_info().height);
+        };
+
+        run_queries(0, depth.get());
+        if (sts[0] == status_feature_unsupported) continue;
+        ASSERT_LE(status_no_error, sts[0]);
+
+        // the threads share a copy of the depth frame, so they don't find the color to depth mapping of the calling thread
+        std::vector<uint8_t> depth_copy(static_cast<const uint8_t*>(depth->query_data()), static_cast<const uint8_t*>(depth->query_data()) + depthPitch * m_depth_intrin.height);
+        auto shared_depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {depth_copy.data(), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+        std::vector<std::thread> threads;
+        for (int t = 1; t <= threads_count; t++)
+            threads.push_back(std::thread(run_queries, t, shared_depth.get()));
+        for (auto & thread : threads)
+            thread.join();
+
+        for (int t = 1; t <= threads_count; t++)
+        {
+            ASSERT_EQ(sts[0], sts[t]) << "thread " << t;
+            EXPECT_EQ(0, memcmp(uvMap[0].data(), uvMap[t].data(), uvMap[0].size() * sizeof(pointF32))) << "thread " << t;
+            EXPECT_EQ(0, memcmp(depthPoints[0].data(), depthPoints[t].data(), depthPoints[0].size() * sizeof(pointF32))) << "thread " << t;
+            EXPECT_EQ(depth2color[0], depth2color[t]) << "thread " << t;
+        }
+    }
+}
+
+/*
+    Test:
+        create_mapped_images_to_caller_buffers
+
+    Target:
+        Checks the mapped images creation to caller provided buffers against the image returning creation
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Creates Color mapped to Depth and Depth mapped to Color images, and maps the same images twice to caller buffers with a padded pitch.
+        Maps to a buffer described with a wrong resolution.
+
+    Pass Criteria:
+        Test passes if the buffers rows are equal to the created images rows, and the wrong resolution is rejected.
+*/
+TEST_F(projection_fixture, create_mapped_images_to_caller_buffers)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    const int32_t pitch_padding = 64;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        m_device->set_frame_by_index(i, rs::stream::color);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+        int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+        image_info  ColorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&ColorInfo,
+                            {m_device->get_frame_data(rs::stream::color), nullptr},
+                            stream_type::color,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::color),
+                            m_device->get_frame_number(rs::stream::color)));
+
+        auto color2depth = get_unique_ptr_with_releaser(m_projection->create_color_image_mapped_to_depth(depth.get(), color.get()));
+        auto depth2color = get_unique_ptr_with_releaser(m_projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+        if (!color2depth || !depth2color) continue;
+
+        image_info color2depth_info = color2depth->query_info();
+        image_info depth2color_info = depth2color->query_info();
+        int32_t color2depth_row_size = color2depth_info.pitch;
+        int32_t depth2color_row_size = depth2color_info.pitch;
+        color2depth_info.pitch += pitch_padding;
+        depth2color_info.pitch += pitch_padding;
+        std::vector<uint8_t> color2depth_buffer(color2depth_info.pitch * color2depth_info.height);
+        std::vector<uint8_t> depth2color_buffer(depth2color_info.pitch * depth2color_info.height);
+        for (int call = 0; call < 2; call++)
+        {
+            ASSERT_EQ(status_no_error, m_projection->create_color_image_mapped_to_depth(depth.get(), color.get(), color2depth_info, color2depth_buffer.data()));
+            ASSERT_EQ(status_no_error, m_projection->create_depth_image_mapped_to_color(depth.get(), color.get(), depth2color_info, depth2color_buffer.data()));
+            auto color2depth_data = static_cast<const uint8_t*>(color2depth->query_data());
+            for (int32_t y = 0; y < color2depth_info.height; y++)
+                ASSERT_EQ(0, memcmp(color2depth_data + y * color2depth_row_size, color2depth_buffer.data() + y * color2depth_info.pitch, color2depth_row_size)) << "row " << y;
+            auto depth2color_data = static_cast<const uint8_t*>(depth2color->query_data());
+            for (int32_t y = 0; y < depth2color_info.height; y++)
+                ASSERT_EQ(0, memcmp(depth2color_data + y * depth2color_row_size, depth2color_buffer.data() + y * depth2color_info.pitch, depth2color_row_size)) << "row " << y;
+        }
+
+        image_info wrong_info = color2depth_info;
+        wrong_info.height /= 2;
+        EXPECT_EQ(status_param_unsupported, m_projection->create_color_image_mapped_to_depth(depth.get(), color.get(), wrong_info, color2depth_buffer.data()));
+        wrong_info = depth2color_info;
+        wrong_info.width /= 2;
+        EXPECT_EQ(status_param_unsupported, m_projection->create_depth_image_mapped_to_color(depth.get(), color.get(), wrong_info, depth2color_buffer.data()));
+    }
+}
+
+/*
+    Test:
+        create_depth_image_mapped_to_color_splat
+
+    Target:
+        Checks the splat registration of create_depth_image_mapped_to_color
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Builds the expected registered depth image from the UV Map, keeping the nearest depth mapped to each color pixel,
+        and creates the Depth mapped to Color image with the splat registration, with a single thread and with 4 threads.
+        Creates the image with the 2x2 splat registration.
+
+    Pass Criteria:
+        Test passes if the splat images are equal to the expected image, and the 2x2 splat image keeps every splat pixel
+        with the same or a nearer depth.
+*/
+TEST_F(projection_fixture, create_depth_image_mapped_to_color_splat)
+{
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+        m_device->set_frame_by_index(i, rs::stream::color);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+        int colorPitch = m_color_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::color_format));
+        image_info  ColorInfo = { m_color_intrin.width, m_color_intrin.height, convert_pixel_format(projection_tests_util::color_format), colorPitch };
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&ColorInfo,
+                            {m_device->get_frame_data(rs::stream::color), nullptr},
+                            stream_type::color,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::color),
+                            m_device->get_frame_number(rs::stream::color)));
+
+        std::vector<pointF32> uvMap(m_depth_intrin.width * m_depth_intrin.height);
+        m_sts = m_projection->query_uvmap(depth.get(), uvMap.data());
+        if (m_sts == status_feature_unsupported) continue;
+        ASSERT_EQ(status_no_error, m_sts);
+
+        const uint16_t* depth_data = static_cast<const uint16_t*>(depth->query_data());
+        std::vector<uint16_t> expected(m_color_intrin.width * m_color_intrin.height, 0);
+        for (int p = 0; p < m_depth_intrin.width * m_depth_intrin.height; p++)
+        {
+            if (depth_data[p] == 0 || uvMap[p].x < 0.f) continue;
+            uint16_t &pixel = expected[static_cast<int>(uvMap[p].y * (float)m_color_intrin.height) * m_color_intrin.width + static_cast<int>(uvMap[p].x * (float)m_color_intrin.width)];
+            if (pixel == 0 || depth_data[p] < pixel) pixel = depth_data[p];
+        }
+
+        image_info depth2color_info = { m_color_intrin.width, m_color_intrin.height, DepthInfo.format, m_color_intrin.width * static_cast<int32_t>(sizeof(uint16_t)) };
+        std::vector<uint16_t> splat(expected.size()), splat_2x2(expected.size());
+        ASSERT_EQ(status_no_error, m_projection->set_depth_to_color_registration(depth_to_color_registration::splat));
+        const uint32_t threads_count[2] = { 1, 4 };
+        for (int t = 0; t < 2; t++)
+        {
+            ASSERT_EQ(status_no_error, m_projection->set_threads_count(threads_count[t]));
+            ASSERT_EQ(status_no_error, m_projection->create_depth_image_mapped_to_color(depth.get(), color.get(), depth2color_info, reinterpret_cast<uint8_t*>(splat.data())));
+            EXPECT_EQ(expected, splat) << threads_count[t] << " threads";
+        }
+        m_projection->set_threads_count(1);
+
+        ASSERT_EQ(status_no_error, m_projection->set_depth_to_color_registration(depth_to_color_registration::splat_2x2));
+        ASSERT_EQ(status_no_error, m_projection->create_depth_image_mapped_to_color(depth.get(), color.get(), depth2color_info, reinterpret_cast<uint8_t*>(splat_2x2.data())));
+        m_projection->set_depth_to_color_registration(depth_to_color_registration::inverse_uvmap);
+        for (size_t p = 0; p < splat.size(); p++)
+        {
+            if (splat[p] == 0) continue;
+            ASSERT_NE(0, splat_2x2[p]) << "pixel " << p;
+            ASSERT_LE(splat_2x2[p], splat[p]) << "pixel " << p;
+        }
+    }
+}
+
+/*
+    Test:
+        instances_of_same_calibration_match
+
+    Target:
+        Checks projection instances which are created with the same and with a different calibration
+
+    Scope:
+        All available '.rssdk' files from PROJECTION folder with different aspect ratios and serialized projection data
+
+    Description:
+        Creates a second instance with the fixture intrinsics and extrinsics, which reuses the cached calibration data,
+        and a third instance with a different depth focal length, then gets UV Map and vertices of the same depth image from all of them.
+
+    Pass Criteria:
+        Test passes if the second instance shares the fixture instance projection spec buffer and the third instance doesn't,
+        and the second instance results are equal to the fixture instance results, and the third instance vertices differ.
+*/
+TEST_F(projection_fixture, instances_of_same_calibration_match)
+{
+    auto same_projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&m_color_intrin, &m_depth_intrin, &m_extrinsics));
+    ASSERT_NE(nullptr, same_projection);
+    intrinsics other_depth_intrin = m_depth_intrin;
+    other_depth_intrin.fx *= 1.01f;
+    auto other_projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&m_color_intrin, &other_depth_intrin, &m_extrinsics));
+    ASSERT_NE(nullptr, other_projection);
+
+    auto projection_ds4 = dynamic_cast<ds4_projection*>(m_projection.get());
+    auto same_projection_ds4 = dynamic_cast<ds4_projection*>(same_projection.get());
+    auto other_projection_ds4 = dynamic_cast<ds4_projection*>(other_projection.get());
+    ASSERT_TRUE(projection_ds4 && same_projection_ds4 && other_projection_ds4);
+    ASSERT_NE(nullptr, projection_ds4->query_projection_spec());
+    EXPECT_EQ(projection_ds4->query_projection_spec(), same_projection_ds4->query_projection_spec());
+    EXPECT_NE(projection_ds4->query_projection_spec(), other_projection_ds4->query_projection_spec());
+
+    const int32_t skipped_frames_at_begin = 5;
+    const int32_t tested_frames = 3;
+    for (int i = skipped_frames_at_begin; i < std::min(projection_tests_util::total_frames, skipped_frames_at_begin + tested_frames); i++)
+    {
+        m_device->set_frame_by_index(i, rs::stream::depth);
+
+        int depthPitch = m_depth_intrin.width * get_pixel_size(rs::utils::convert_pixel_format(projection_tests_util::depth_format));
+        image_info  DepthInfo = { m_depth_intrin.width, m_depth_intrin.height, convert_pixel_format(projection_tests_util::depth_format), depthPitch };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&DepthInfo,
+                            {m_device->get_frame_data(rs::stream::depth), nullptr},
+                            stream_type::depth,
+                            image_interface::flag::any,
+                            m_device->get_frame_timestamp(rs::stream::depth),
+                            m_device->get_frame_number(rs::stream::depth)));
+
+        const int32_t depth_size = m_depth_intrin.width * m_depth_intrin.height;
+        std::vector<pointF32> uvMap(depth_size), same_uvMap(depth_size);
+        std::vector<point3dF32> vertices(depth_size), same_vertices(depth_size), other_vertices(depth_size);
+        m_sts = m_projection->query_uvmap(depth.get(), uvMap.data());
+        if (m_sts == status_feature_unsupported) continue;
+        ASSERT_EQ(status_no_error, m_sts);
+        ASSERT_EQ(status_no_error, same_projection->query_uvmap(depth.get(), same_uvMap.data()));
+        ASSERT_EQ(status_no_error, m_projection->query_vertices(depth.get(), vertices.data()));
+        ASSERT_EQ(status_no_error, same_projection->query_vertices(depth.get(), same_vertices.data()));
+        ASSERT_EQ(status_no_error, other_projection->query_vertices(depth.get(), other_vertices.data()));
+
+        EXPECT_EQ(0, memcmp(uvMap.data(), same_uvMap.data(), uvMap.size() * sizeof(pointF32)));
+        EXPECT_EQ(0, memcmp(vertices.data(), same_vertices.data(), vertices.size() * sizeof(point3dF32)));
+        EXPECT_NE(0, memcmp(vertices.data(), other_vertices.data(), vertices.size() * sizeof(point3dF32)));
+    }
+}
+
+/*
+    Test:
+        projection_16u32f_vectorized_matches_reference
+
+    Target:
+        Checks the vectorized row kernels of rs_projection_16u32f_c1cxr against its scalar reference
+
+    Scope:
+        1. Synthetic depth image with invalid pixels and a width which isn't a multiple of the vector size
+        2. Projection to a distorted camera with rotation and translation, projection without rotation, and camera coordinates
+
+    Description:
+        The depth image is projected by each row kernel supported by the running cpu and by the scalar reference.
+        The vectorized kernels use single precision distortion and fused multiply-add, so the results are compared with a tolerance
+        of 0.001 pixel for the uvmap and 0.001mm for the vertices.
+
+    Pass Criteria:
+        Test passes if both projections return the same status and all the outputs are within the tolerance.
+*/
+TEST(projection_math, projection_16u32f_vectorized_matches_reference)
+{
+    math_projection projection;
+    sizeI32 size = {641, 480};
+    int spec_size = 0;
+    ASSERT_EQ(status_no_error, projection.rs_projection_get_size_32f(size, &spec_size));
+    std::vector<unsigned char> spec_buffer(static_cast<size_t>(spec_size), 0);
+    auto spec = reinterpret_cast<projection_spec_32f*>(spec_buffer.data());
+    float camera_src[4] = {475.f, 320.f, 475.f, 240.f};
+    float inv_distortion[5] = {0.1f, -0.05f, 0.001f, 0.002f, 0.01f};
+    ASSERT_EQ(status_no_error, projection.rs_projection_init_32f(size, camera_src, inv_distortion, spec));
+
+    std::vector<unsigned short> depth(static_cast<size_t>(size.width * size.height));
+    srand(1);
+    for(auto & value : depth)
+        value = rand() % 5 == 0 ? 0 : static_cast<unsigned short>(300 + rand() % 4000);
+
+    float rotation[9] = {0.9998f, 0.01f, -0.015f, -0.0101f, 0.9999f, 0.005f, 0.0149f, -0.0052f, 0.9998f};
+    float translation[3] = {25.f, 0.3f, -1.2f};
+    float distortion[5] = {0.12f, -0.25f, 0.001f, -0.0008f, 0.1f};
+    float camera_dst[4] = {615.f, 320.f, 615.f, 240.f};
+
+    //every kernel supported by the running cpu is tested, not only the one selected for it
+    struct row_kernel { const char * name; projection_row_kernel kernel; };
+    std::vector<row_kernel> kernels;
+#if defined(PROJECTION_SIMD) && defined(__GNUC__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("sse4.1"))
+        kernels.push_back({"sse4.1", projection_row_16u32f_sse41});
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        kernels.push_back({"avx2", projection_row_16u32f_avx2});
+#endif
+    if(kernels.empty())
+        kernels.push_back({"dispatched", nullptr});
+
+    struct projection_case { float * rotation; float * distortion; float * camera; float tolerance; };
+    const projection_case cases[] =
+    {
+        {rotation, distortion, camera_dst, 0.001f},  //uvmap, pixels
+        {nullptr, distortion, camera_dst, 0.001f},   //uvmap without rotation, pixels
+        {rotation, nullptr, nullptr, 0.001f},        //vertices, mm
+    };
+    for(auto & kernel : kernels)
+    {
+        for(auto & test_case : cases)
+        {
+            int channels = test_case.camera ? 2 : 3;
+            std::vector<float> reference(depth.size() * static_cast<size_t>(channels)), vectorized(reference.size());
+            int src_step = size.width * static_cast<int>(sizeof(unsigned short));
+            int dst_step = size.width * channels * static_cast<int>(sizeof(float));
+            auto reference_status = projection.rs_projection_16u32f_c1cxr_ref(depth.data(), size, src_step, reference.data(), dst_step,
+                                                                              test_case.rotation, translation, test_case.distortion, test_case.camera, spec);
+            auto vectorized_status = kernel.kernel ?
+                projection.rs_projection_16u32f_c1cxr_kernel(depth.data(), size, src_step, vectorized.data(), dst_step,
+                                                             test_case.rotation, translation, test_case.distortion, test_case.camera, spec, kernel.kernel) :
+                projection.rs_projection_16u32f_c1cxr(depth.data(), size, src_step, vectorized.data(), dst_step,
+                                                      test_case.rotation, translation, test_case.distortion, test_case.camera, spec);
+            ASSERT_EQ(reference_status, vectorized_status) << kernel.name;
+            for(size_t i = 0; i < reference.size(); i++)
+                ASSERT_NEAR(reference[i], vectorized[i], test_case.tolerance) << kernel.name << " at " << i;
+        }
+    }
+}
+
+/*
+    Test:
+        array_projection_specialized_matches_reference
+
+    Target:
+        Checks the stage specialized rs_3d_array_projection_32f and rs_3d_array_projection_soa_32f against the reference projection
+
+    Scope:
+        All the combinations of source camera, inverse distortion, rotation, translation, destination distortion and destination camera
+
+    Description:
+        Random points, including a point on the camera plane, are projected by the specialized float projections and by the double precision reference.
+
+    Pass Criteria:
+        Test passes if all the outputs are within a relative tolerance of the reference outputs.
+*/
+TEST(projection_math, array_projection_specialized_matches_reference)
+{
+    math_projection projection;
+    const int length = 1001;
+    std::vector<float> points(length * 3);
+    srand(1);
+    for(int i = 0; i < length; i++)
+    {
+        points[i * 3] = static_cast<float>(rand() % 640);
+        points[i * 3 + 1] = static_cast<float>(rand() % 480);
+        points[i * 3 + 2] = static_cast<float>(300 + rand() % 4000);
+    }
+    points[30] = points[31] = points[32] = 0.f;
+    std::vector<float> src_x(length), src_y(length), src_z(length);
+    for(int i = 0; i < length; i++)
+    {
+        src_x[i] = points[i * 3];
+        src_y[i] = points[i * 3 + 1];
+        src_z[i] = points[i * 3 + 2];
+    }
+
+    float camera_src[4] = {475.f, 320.f, 475.f, 240.f};
+    float inv_distortion[5] = {0.1f, -0.05f, 0.001f, 0.002f, 0.01f};
+    float rotation[9] = {0.9998f, 0.01f, -0.015f, -0.0101f, 0.9999f, 0.005f, 0.0149f, -0.0052f, 0.9998f};
+    float translation[3] = {25.f, 0.3f, -1.2f};
+    float distortion[5] = {0.12f, -0.25f, 0.001f, -0.0008f, 0.1f};
+    float camera_dst[4] = {615.f, 320.f, 615.f, 240.f};
+
+    for(int stages = 0; stages < 64; stages++)
+    {
+        float * stage_camera_src = (stages & 1) ? camera_src : nullptr;
+        float * stage_inv_distortion = (stages & 2) ? inv_distortion : nullptr;
+        float * stage_rotation = (stages & 4) ? rotation : nullptr;
+        float * stage_translation = (stages & 8) ? translation : nullptr;
+        float * stage_distortion = (stages & 16) ? distortion : nullptr;
+        float * stage_camera_dst = (stages & 32) ? camera_dst : nullptr;
+        int channels = stage_camera_dst ? 2 : 3;
+
+        std::vector<float> reference(length * 3), specialized(length * 3);
+        std::vector<float> dst_x(length), dst_y(length), dst_z(length);
+        ASSERT_EQ(status_no_error, projection.rs_3d_array_projection_32f_ref(points.data(), reference.data(), length, stage_camera_src, stage_inv_distortion,
+                                                                              stage_rotation, stage_translation, stage_distortion, stage_camera_dst));
+        ASSERT_EQ(status_no_error, projection.rs_3d_array_projection_32f(points.data(), specialized.data(), length, stage_camera_src, stage_inv_distortion,
+                                                                          stage_rotation, stage_translation, stage_distortion, stage_camera_dst));
+        ASSERT_EQ(status_no_error, projection.rs_3d_array_projection_soa_32f(src_x.data(), src_y.data(), src_z.data(), dst_x.data(), dst_y.data(), dst_z.data(), length,
+                                                                              stage_camera_src, stage_inv_distortion, stage_rotation, stage_translation, stage_distortion, stage_camera_dst));
+        for(int i = 0; i < length; i++)
+        {
+            const float soa[3] = {dst_x[i], dst_y[i], dst_z[i]};
+            for(int c = 0; c < channels; c++)
+            {
+                float expected = reference[i * channels + c];
+                float tolerance = 1e-4f * std::max(1.f, std::fabs(expected));
+                ASSERT_NEAR(expected, specialized[i * channels + c], tolerance) << "stages " << stages << ", point " << i;
+                ASSERT_NEAR(expected, soa[c], tolerance) << "stages " << stages << ", point " << i;
+            }
+        }
+    }
+}
+
+/*
+    Test:
+        fisheye_distortion_round_trip
+
+    Target:
+        Checks rs_fisheye_distortion_32f_c2ir, rs_fisheye_undistortion_32f_c3r and rs_remap_8u_cnr
+
+    Scope:
+        1. Normalized points covering the fisheye field of view, a point of a zero depth pixel and the origin point
+        2. Nearest and bilinear remap of a single channel and a 3 channel image
+
+    Description:
+        The points are distorted to fisheye pixels and undistorted back to 3d points at a fixed depth.
+        The images are remapped by a half pixel horizontal shift, with a map point out of the image.
+
+    Pass Criteria:
+        Test passes if the undistorted points match the source points, the zero depth point is set to -1,
+        the origin point is mapped to the principal point unless it is marked invalid, and the remapped pixels match the expected interpolation and default value.
+*/
+TEST(projection_math, fisheye_distortion_round_trip)
+{
+    math_projection projection;
+    const float camera[4] = {330.f, 320.f, 330.f, 240.f};
+    const float fisheye_coeff = 0.92f;
+    const float depth = 1500.f;
+
+    std::vector<pointF32> points;
+    for(float y = -1.5f; y <= 1.5f; y += 0.1f)
+        for(float x = -1.5f; x <= 1.5f; x += 0.1f)
+            points.push_back({x, y});
+    points.push_back({0.f, 0.f});
+    const int length = static_cast<int>(points.size());
+    std::vector<pointF32> pixels(points);
+    std::vector<unsigned short> depths(length, static_cast<unsigned short>(depth));
+    depths[length - 2] = 0;
+    sizeI32 roi_size = {length, 1};
+    ASSERT_EQ(status_no_error, projection.rs_fisheye_distortion_32f_c2ir((float*)pixels.data(), length * static_cast<int>(sizeof(pointF32)), roi_size,
+                                                                         depths.data(), length * static_cast<int>(sizeof(unsigned short)), false, fisheye_coeff, camera));
+    EXPECT_EQ(-1.f, pixels[length - 2].x);
+    EXPECT_EQ(-1.f, pixels[length - 2].y);
+    EXPECT_FLOAT_EQ(camera[1], pixels[length - 1].x);
+    EXPECT_FLOAT_EQ(camera[3], pixels[length - 1].y);
+
+    pointF32 origin = {0.f, 0.f};
+    sizeI32 origin_size = {1, 1};
+    ASSERT_EQ(status_no_error, projection.rs_fisheye_distortion_32f_c2ir((float*)&origin, static_cast<int>(sizeof(pointF32)), origin_size,
+                                                                         nullptr, 0, true, fisheye_coeff, camera));
+    EXPECT_EQ(-1.f, origin.x);
+    EXPECT_EQ(-1.f, origin.y);
+
+    std::vector<point3dF32> pixels_ijz(length), undistorted(length);
+    for(int i = 0; i < length; i++)
+        pixels_ijz[i] = {pixels[i].x, pixels[i].y, depth};
+    ASSERT_EQ(status_no_error, projection.rs_fisheye_undistortion_32f_c3r((const float*)pixels_ijz.data(), (float*)undistorted.data(), length, fisheye_coeff, camera));
+    for(int i = 0; i < length; i++)
+    {
+        if(depths[i] == 0) continue;
+        EXPECT_NEAR(points[i].x * depth, undistorted[i].x, 1e-2f) << "point " << i;
+        EXPECT_NEAR(points[i].y * depth, undistorted[i].y, 1e-2f) << "point " << i;
+        EXPECT_FLOAT_EQ(depth, undistorted[i].z) << "point " << i;
+    }
+
+    const int width = 5, height = 4;
+    const unsigned char default_value = 7;
+    sizeI32 image_size = {width, height};
+    std::vector<float> map(width * height * 2);
+    for(int y = 0; y < height; y++)
+        for(int x = 0; x < width; x++)
+        {
+            map[(y * width + x) * 2] = x + 0.5f;
+            map[(y * width + x) * 2 + 1] = static_cast<float>(y);
+        }
+    map[0] = -3.f;
+    for(int channels = 1; channels <= 3; channels += 2)
+    {
+        std::vector<unsigned char> image(width * height * channels), nearest(image.size()), bilinear(image.size());
+        for(size_t i = 0; i < image.size(); i++)
+            image[i] = static_cast<unsigned char>(i * 4);
+        int step = width * channels;
+        ASSERT_EQ(status_no_error, projection.rs_remap_8u_cnr(image.data(), image_size, step, channels, map.data(), width * 2 * static_cast<int>(sizeof(float)),
+                                                              nearest.data(), image_size, step, 0, default_value));
+        ASSERT_EQ(status_no_error, projection.rs_remap_8u_cnr(image.data(), image_size, step, channels, map.data(), width * 2 * static_cast<int>(sizeof(float)),
+                                                              bilinear.data(), image_size, step, 1, default_value));
+        for(int y = 0; y < height; y++)
+            for(int x = 0; x < width - 1; x++)
+                for(int c = 0; c < channels; c++)
+                {
+                    int i = y * step + x * channels + c;
+                    if(x == 0 && y == 0)
+                    {
+                        EXPECT_EQ(default_value, nearest[i]);
+                        EXPECT_EQ(default_value, bilinear[i]);
+                        continue;
+                    }
+                    EXPECT_EQ((image[i] + image[i + channels]) / 2, bilinear[i]) << "channels " << channels << ", pixel " << x << "," << y;
+                    EXPECT_TRUE(nearest[i] == image[i] || nearest[i] == image[i + channels]) << "channels " << channels << ", pixel " << x << "," << y;
+                }
+    }
+}
+
+/*
+    Test:
+        fisheye_projection_from_intrinsics_extrinsics
+
+    Target:
+        Checks the projection instance of fisheye color intrinsics
+
+    Scope:
+        Synthetic fisheye intrinsics of the f-theta model, depth intrinsics and depth to fisheye extrinsics with a rotation
+
+    Description:
+        Depth camera points are projected to the fisheye image and compared with the f-theta model applied to the transformed points,
+        then projected back from the fisheye pixels to the depth camera.
+        A point on the fisheye camera plane is projected by an instance of identity extrinsics.
+        A synthetic fisheye image is undistorted.
+
+    Pass Criteria:
+        Test passes if the projected pixels match the f-theta model, the points return to the source points,
+        the point on the camera plane is set to -1, and the undistorted image keeps the principal point pixel.
+*/
+TEST(projection_fisheye, fisheye_projection_from_intrinsics_extrinsics)
+{
+    intrinsics fisheye_intrin = {640, 480, 322.5f, 243.f, 330.f, 331.f, distortion_type::distortion_ftheta, {0.92f, 0.f, 0.f, 0.f, 0.f}};
+    intrinsics depth_intrin = {628, 468, 310.f, 235.f, 475.f, 475.f, distortion_type::none, {0.f, 0.f, 0.f, 0.f, 0.f}};
+    const float angle = 0.05f;
+    extrinsics depth_to_fisheye = {{std::cos(angle), 0.f, -std::sin(angle), 0.f, 1.f, 0.f, std::sin(angle), 0.f, std::cos(angle)}, {0.04f, -0.002f, 0.001f}};
+    auto projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&fisheye_intrin, &depth_intrin, &depth_to_fisheye));
+    ASSERT_NE(nullptr, projection);
+
+    std::vector<point3dF32> points;
+    for(float y = -600.f; y <= 600.f; y += 150.f)
+        for(float x = -800.f; x <= 800.f; x += 200.f)
+            points.push_back({x, y, 1000.f + std::fabs(x)});
+    const int32_t npoints = static_cast<int32_t>(points.size());
+    std::vector<pointF32> pixels(npoints);
+    ASSERT_EQ(status_no_error, projection->project_camera_to_color(npoints, points.data(), pixels.data()));
+
+    std::vector<point3dF32> pixels_ijz(npoints), camera_points(npoints);
+    for(int32_t i = 0; i < npoints; i++)
+    {
+        // the extrinsics rotation is column major and the translation is in meters
+        const float *r = depth_to_fisheye.rotation;
+        const float *t = depth_to_fisheye.translation;
+        point3dF32 &p = points[i];
+        float fx = r[0] * p.x + r[3] * p.y + r[6] * p.z + t[0] * 1000.f;
+        float fy = r[1] * p.x + r[4] * p.y + r[7] * p.z + t[1] * 1000.f;
+        float fz = r[2] * p.x + r[5] * p.y + r[8] * p.z + t[2] * 1000.f;
+        float u = fx / fz, v = fy / fz;
+        float radius = std::sqrt(u * u + v * v);
+        float w = fisheye_intrin.coeffs[0];
+        float scale = radius > 0.f ? std::atan(2.f * radius * std::tan(w / 2.f)) / (w * radius) : 1.f;
+        EXPECT_NEAR(u * scale * fisheye_intrin.fx + fisheye_intrin.ppx, pixels[i].x, 1e-2f) << "point " << i;
+        EXPECT_NEAR(v * scale * fisheye_intrin.fy + fisheye_intrin.ppy, pixels[i].y, 1e-2f) << "point " << i;
+        pixels_ijz[i] = {pixels[i].x, pixels[i].y, fz};
+    }
+    ASSERT_EQ(status_no_error, projection->project_color_to_camera(npoints, pixels_ijz.data(), camera_points.data()));
+    for(int32_t i = 0; i < npoints; i++)
+    {
+        EXPECT_NEAR(points[i].x, camera_points[i].x, 0.5f) << "point " << i;
+        EXPECT_NEAR(points[i].y, camera_points[i].y, 0.5f) << "point " << i;
+        EXPECT_NEAR(points[i].z, camera_points[i].z, 0.5f) << "point " << i;
+    }
+
+    // a point of zero depth in the fisheye camera isn't mapped to the principal point
+    extrinsics identity_extrin = {{1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f}, {0.f, 0.f, 0.f}};
+    auto identity_projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&fisheye_intrin, &depth_intrin, &identity_extrin));
+    ASSERT_NE(nullptr, identity_projection);
+    point3dF32 plane_points[2] = {{100.f, 50.f, 0.f}, {100.f, 50.f, 1000.f}};
+    pointF32 plane_pixels[2];
+    ASSERT_EQ(status_no_error, identity_projection->project_camera_to_color(2, plane_points, plane_pixels));
+    EXPECT_EQ(-1.f, plane_pixels[0].x);
+    EXPECT_EQ(-1.f, plane_pixels[0].y);
+    EXPECT_GT(plane_pixels[1].x, fisheye_intrin.ppx);
+    EXPECT_GT(plane_pixels[1].y, fisheye_intrin.ppy);
+
+    image_info fisheye_info = {fisheye_intrin.width, fisheye_intrin.height, pixel_format::raw8, fisheye_intrin.width};
+    std::vector<uint8_t> fisheye_data(fisheye_info.pitch * fisheye_info.height);
+    for(int32_t y = 0; y < fisheye_info.height; y++)
+        for(int32_t x = 0; x < fisheye_info.width; x++)
+            fisheye_data[y * fisheye_info.pitch + x] = static_cast<uint8_t>((x + y) & 0xff);
+    auto fisheye = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&fisheye_info, {fisheye_data.data(), nullptr},
+                                                                                              stream_type::fisheye, image_interface::flag::any, 0, 0));
+    std::vector<uint8_t> undistorted_data(fisheye_data.size());
+    ASSERT_EQ(status_no_error, projection->undistort_color_image(fisheye.get(), fisheye_info, undistorted_data.data()));
+    int32_t center = static_cast<int32_t>(fisheye_intrin.ppy) * fisheye_info.pitch + static_cast<int32_t>(fisheye_intrin.ppx);
+    EXPECT_NEAR(fisheye_data[center], undistorted_data[center], 1);
+    image_info wrong_info = fisheye_info;
+    wrong_info.format = pixel_format::y8;
+    EXPECT_EQ(status_param_unsupported, projection->undistort_color_image(fisheye.get(), wrong_info, undistorted_data.data()));
+}